@@ -8,10 +8,38 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdalign.h>
+#include "trace_reader.h"
+#include "event_log.h"
+#include "select_next.h"
+#include "ready_queue.h"
+#include "policy_step.h"
+#include "select_simd.h"
+#include "arrival_sort.h"
+#include "online_stats.h"
+#include "gantt_log.h"
+#include "gantt_render.h"
+#include "perf_counter.h"
+#include "instrument.h"
 
 //  Define constants
-#define MAX_PROC 10
-#define MAX_TIMELINE 1000
+#define ARENA_ALIGNMENT 16      // Alignment of every arena allocation
+#define RING_CAPACITY 64        // Slots per lock-free ring (power of two)
+#define RING_SPIN_PAUSES 64     // Polls of a ring with a CPU pause hint before yielding
+#define RING_SPIN_YIELDS 16     // Polls with sched_yield() before sleeping on the ring
+#define CACHE_LINE 64           // Keeps ring indices written by different threads apart
+#define STREAM_INITIAL_SLOTS 1024 // Process table rows allocated when streaming starts
+#define GANTT_FULL_MAX_UNITS 1000 // Longer charts are downsampled unless --gantt-width=full
+#define GANTT_DEFAULT_WIDTH 100   // Columns of a downsampled chart when the terminal width is unknown
+#define GANTT_SVG_WIDTH 1200      // Columns (pixels) of an SVG chart without --gantt-width
+#define CORE_STEP_EVENTS 3        // Timeline events of one CPU in one step (preemption, run, completion)
+#define REALTIME_MAX_DELAY 3600.0  // Longest --realtime pause for one step, in seconds
 
 // Enum for process states
 typedef enum {
@@ -20,33 +48,56 @@ typedef enum {
     COMPLETED   // Process finished execution
 } ProcessState;
 
-// Structure representing each process
+// Kinds of timeline events sent to the event log
+typedef enum {
+    EVENT_READY,       // pid arrived; arg = Remaining Time
+    EVENT_RUNNING,     // pid was dispatched
+    EVENT_COMPLETED,   // pid finished
+    EVENT_IDLE,        // CPU idle from time until arg
+    EVENT_PREEMPTION   // Switch from pid to arg
+} EventType;
+
+// Process table, stored as a structure of arrays: column[i] is the field of
+// process i. Scans and heap operations touch only the columns they read
+// (e.g. arrivalTime, finished and remainingTime in findShortestJob), instead
+// of dragging whole records with thread handles through the cache.
 typedef struct {
-    int pid;               // Process ID (1, 2, 3...)
-    int arrivalTime;       // Time when the process arrives
-    int burstTime;         // CPU burst duration
-    int remainingTime;     // Remaining CPU time
-    int startTime;         // First time process gets CPU
-    int completionTime;    // Time when process finishes
-    int turnaroundTime;    // completionTime - arrivalTime
-    int waitingTime;       // turnaroundTime - burstTime
-    int responseTime;      // startTime - arrivalTime
-    int finished;          // 0 = not completed, 1 = completed
-    int hasStarted;        // Track if process has started execution
-    ProcessState state;    // Current state of the process
-    pthread_t thread;      // Thread for this process
-} Process;
-
-// Gantt chart structure
+    int *pid;                  // Process ID (1, 2, 3...)
+    int *arrivalTime;          // Time when the process arrives
+    int *burstTime;            // CPU burst duration
+    int *priority;             // Priority from the trace file (0 if not given)
+    int *remainingTime;        // Remaining CPU time
+    long *queueKey;            // Ready-queue order, set by the scheduling policy
+    long *sequence;            // Position in arrival order; breaks ties between equal keys
+    int *startTime;            // First time process gets CPU
+    int *completionTime;       // Time when process finishes
+    int *turnaroundTime;       // completionTime - arrivalTime
+    int *waitingTime;          // turnaroundTime - burstTime
+    int *responseTime;         // startTime - arrivalTime
+    unsigned char *finished;   // 0 = not completed, 1 = completed
+    unsigned char *hasStarted; // Track if process has started execution
+    ProcessState *state;       // Current state of the process
+    pthread_t *thread;         // Thread for this process
+    pthread_cond_t *wakeCond;  // Signalled when this process is dispatched
+} ProcessTable;
+
+// Every column of ProcessTable, for allocating and permuting them together
+#define PROCESS_COLUMNS(X) \
+    X(pid) X(arrivalTime) X(burstTime) X(priority) X(remainingTime) X(queueKey) X(sequence) \
+    X(startTime) X(completionTime) X(turnaroundTime) X(waitingTime) X(responseTime) \
+    X(finished) X(hasStarted) X(state) X(thread) X(wakeCond)
+
+// Bump allocator backed by a single allocation sized from the input
+// Used for the Process table and the ready queue, which all live until exit
 typedef struct {
-    int pid;               // Process ID executing
-    int startTime;         // Start time of this execution slice
-    int endTime;           // End time of this execution slice
-} GanttEntry;
+    char *base;            // Start of the allocation
+    size_t used;           // Bytes handed out so far
+    size_t capacity;       // Total bytes available
+} Arena;
 
 // Shared data structure for threading
 typedef struct {
-    Process *processes;
+    ProcessTable *processes;
     int n;
     int *currentTime;
     int *completed;
@@ -58,43 +109,545 @@ typedef struct {
     int *ganttSize;
 } SharedData;
 
+// Dispatch or completion record passed between the scheduler and a worker
+typedef struct {
+    int idx;               // Index of the process in processes[] (-1 tells the worker to exit)
+    int start;             // Time the slice starts
+    int slice;             // Time units to run
+    int completes;         // 1 if the process finishes with this slice
+} SliceRecord;
+
+// Single-producer/single-consumer ring buffer
+// Only the producer writes tail and only the consumer writes head, so a
+// release store on one side paired with an acquire load on the other is all
+// the synchronisation needed
+// A thread that has waited too long for a record (consumer) or a free slot
+// (producer) sleeps on parkCond; the two never wait at once, since the ring
+// cannot be empty and full together, so one flag and condition do
+typedef struct {
+    alignas(CACHE_LINE) atomic_uint head;      // Next slot to read (consumer)
+    alignas(CACHE_LINE) atomic_uint tail;      // Next slot to write (producer)
+    alignas(CACHE_LINE) atomic_bool parked;    // A thread sleeps on parkCond
+    pthread_mutex_t parkMutex;
+    pthread_cond_t parkCond;
+    alignas(CACHE_LINE) SliceRecord slots[RING_CAPACITY];
+} SpscRing;
+
+// Worker thread fed through lock-free rings instead of the scheduler mutex
+typedef struct {
+    SpscRing dispatch;     // Scheduler -> worker
+    SpscRing completion;   // Worker -> scheduler
+    pthread_t thread;      // Thread running lockFreeWorkerThread
+    long dispatched;       // Slices pushed to dispatch (scheduler only)
+    long completed;        // Completion records popped (scheduler only)
+} LockFreeWorker;
+
+// Wall-clock time, context switches and cache misses of one simulation run
+typedef struct {
+    double seconds;        // Wall-clock duration
+    long contextSwitches;  // Context switches of all threads during the run
+    long decisions;        // Slices dispatched by the scheduler
+    long long cacheMisses; // Hardware cache misses of all threads, -1 if unavailable
+} RunStats;
+
+// Scheduling policy plugged into the scheduler thread
+// The engine (ready queue, event loop, metrics, Gantt chart) is shared; a
+// policy only decides the order of the ready queue and when the running
+// process gives up the CPU. The running process is kept out of the ready
+// queue and goes back in (with a fresh key) when it is preempted.
+typedef struct {
+    const char *name;      // Value of --policy
+    const char *label;     // Name shown in the output
+    const char *mode;      // PREEMPTIVE, NON-PREEMPTIVE, ...
+    const char *note;      // Explanation printed above the timeline (may use the quantum)
+    bool arrivalsPreempt;  // An arrival can take the CPU, so event-driven slices stop at arrivals
+    bool usesQuantum;      // The running process yields after timeQuantum units
+    long (*onArrival)(int idx);                              // Key of a process entering the ready queue
+    long (*onPreempt)(int idx);                              // Key of a preempted process going back in
+    bool (*shouldPreempt)(int running, int candidate, int used);  // Replace the running process by the head of the queue?
+    void *(*schedulerThread)(void *arg);                     // Scheduler loop specialised for these hooks (DEFINE_SCHEDULER_LOOP)
+} SchedulingPolicy;
+
+// Processes read from a trace while the simulation runs (--stream)
+// Only arrived, unfinished processes occupy rows of the Process table; a
+// finished process's row is reused by a later arrival, so memory follows the
+// number of live processes rather than the length of the trace
+typedef struct {
+    TraceReader reader;    // Text trace being consumed, in arrival order
+    TraceRecord next;      // Next process of the trace, not admitted yet
+    bool hasNext;          // next holds a record (false at end of trace)
+    bool failed;           // Reading stopped at a malformed or out-of-order line
+    int capacity;          // Rows allocated in the Process table
+    int *freeRows;         // Rows not holding a live process (a stack)
+    int freeCount;         // Entries in freeRows
+    int live;              // Arrived, unfinished processes
+    int peakLive;          // Most live processes at any time
+} ProcessStream;
+
+// Summaries of the per-process metrics, updated as each process completes
+// (online_stats.h), so the results need no pass over the Process table
+typedef struct {
+    OnlineStats turnaround;
+    OnlineStats waiting;
+    OnlineStats response;
+} MetricStats;
+
+// Metric summaries of the processes completed by one thread
+// Each thread running slices writes only its own shard, without locking;
+// runSimulation merges the shards into metricStats once the threads are joined
+// Shards are cache-line aligned so two threads never write the same line
+typedef struct {
+    alignas(CACHE_LINE) MetricStats metrics;
+} StatsShard;
+
+// How the multi-core simulation (--cpus) shares ready processes between CPUs
+typedef enum {
+    QUEUES_GLOBAL,     // One ready queue; the processes with the shortest Remaining Time run
+    QUEUES_PER_CORE    // A ready queue per CPU; a CPU with nothing to run steals from the longest
+} QueueMode;
+
+// Work done by the simulation threads in one step of the multi-core simulation
+typedef enum {
+    CORE_PHASE_SELECT, // Each CPU picks from its own ready queue (per-core queues)
+    CORE_PHASE_RUN,    // Each CPU runs its process for the step's slice
+    CORE_PHASE_EXIT    // The simulation is over
+} CorePhase;
+
+// One simulated CPU of the multi-core simulation
+// Only the simulation thread that owns a CPU writes it during a phase; the
+// scheduling thread changes it between phases
+// Cache-line aligned so CPUs owned by different threads never share a line
+typedef struct {
+    alignas(CACHE_LINE) int running;   // Process on this CPU, -1 if idle
+    int lastPid;           // Last process this CPU ran, for preemption events (-1 if none)
+    ReadyQueue queue;      // Processes waiting for this CPU (per-core queues only)
+    int queueCapacity;     // Slots allocated in queue.heap
+    GanttLog lane;         // Slices run on this CPU, including IDLE time
+    long busyTime;         // Time units spent running processes
+    long slices;           // Slices run
+    long migrations;       // Slices of processes that last ran on another CPU
+    long steals;           // Processes taken from another CPU's ready queue
+    EventRecord events[CORE_STEP_EVENTS]; // Timeline events of the current step, logged after it
+    int eventCount;
+} SimCore;
+
+// Find process with shortest Remaining Time that has arrived
+// If there exists such a process, its index is returned
+// If no such process exists, -1 is returned
+// Scans the first n rows with the widest SIMD kernel the CPU supports
+// (select_simd.h); used by the scheduler with --select=scan
+static inline int findShortestJob(const ProcessTable *table, int n, int currentTime) {
+    return selectShortestRemaining(table->arrivalTime, table->remainingTime, table->finished,
+                                   n, currentTime);
+}
+
 // Global variables (shared data among threads)
-Process processes[MAX_PROC];                                    // Sets a array with a maximum of 10 processes
+Arena processArena;                                             // Backing storage for the Process table and ready queue
+ProcessTable processes;                                         // Process table columns, allocated from processArena
 int globalCurrentTime = 0;                                      // Global time tracker
-int globalCompleted = 0;                                        // Number of completed processes
 int globalCurrentProcess = -1;                                  // Currently executing process index
 bool schedulerRunning = true;                                   // Scheduler running flag
 pthread_mutex_t schedulerMutex = PTHREAD_MUTEX_INITIALIZER;     // Mutex for synchronizing access
 pthread_cond_t schedulerCond = PTHREAD_COND_INITIALIZER;        // Condition variable for process scheduling
-GanttEntry gantt[MAX_TIMELINE];                                 // Gantt chart entries
-int ganttSize = 0;                                              // Number of entries in Gantt chart
+pthread_cond_t sliceDoneCond = PTHREAD_COND_INITIALIZER;        // Signalled when the dispatched slice has run
+GanttLog gantt = {0};                                           // Gantt chart slices (gantt_log.h)
 int numProcesses = 0;                                           // Total number of processes
+int globalSliceLength = 1;                                      // Time units the dispatched process runs for
+bool eventDriven = false;                                       // Jump between events instead of single ticks
+double realtimeScale = 0;                                       // Pacing multiplier, 0 = run at full speed
+const char *traceFile = NULL;                                   // Trace file to load instead of prompting
+int numWorkers = 0;                                             // Worker pool size, 0 = one thread per process
+bool broadcastWakeups = false;                                  // Wake every thread per dispatch (old behaviour)
+bool lockFreeHandoff = false;                                   // Hand slices to workers through SPSC rings
+LockFreeWorker *lockFreeWorkers = NULL;                         // Workers used by the lock-free handoff
+bool printTimeline = true;                                      // Print the execution timeline rows
+const char *eventLogFile = NULL;                                // Write timeline events here in binary instead
+const char *ganttBinaryFile = NULL;                             // Export the Gantt log in binary here
+const char *ganttTraceFile = NULL;                              // Export the Gantt log as Chrome trace JSON here
+const char *ganttSvgFile = NULL;                                // Render the Gantt chart as SVG here
+int ganttWidth = 0;                                             // Columns of a downsampled chart, 0 = auto, -1 = full chart
+bool ganttUtilisation = false;                                  // Downsampled chart shows utilisation, not processes
+EventLog eventLog;                                              // Buffers timeline events for the writer thread
+TraceMapping mappedTrace;                                       // Binary trace the Process table is filled from
+int populatedProcesses = 0;                                     // processes[0..populatedProcesses-1] are filled in
+int *readyHeap = NULL;                                          // Heap storage for the ready queue
+int *readyPos = NULL;                                           // Heap positions for the ready queue
+ReadyQueue readyQueue;                                          // Arrived processes waiting for the CPU
+const SchedulingPolicy *policy = NULL;                          // Policy chosen with --policy (SRTF by default)
+int timeQuantum = 2;                                            // Round Robin time quantum
+long roundRobinSequence = 0;                                    // Round Robin queue order counter
+long schedulingDecisions = 0;                                   // Slices dispatched in the current run
+bool scanSelection = false;                                     // SRTF picks by scanning the table, not the ready queue
+bool streamMode = false;                                        // Read processes while simulating (--stream)
+ProcessStream stream;                                           // Trace and row bookkeeping in streaming mode
+MetricStats metricStats;                                        // Turnaround, waiting and response time summaries
+StatsShard *statsShards = NULL;                                 // Per-thread metric summaries of the current run
+int numStatsShards = 0;                                         // Number of entries in statsShards
+static _Thread_local StatsShard *threadShard = NULL;            // Shard the calling thread records completions in
+int numCpus = 0;                                                // Simulated CPUs, 0 = the single-CPU engine
+QueueMode queueMode = QUEUES_GLOBAL;                            // Ready queue layout of the multi-core simulation
+SimCore *simCores = NULL;                                       // The simulated CPUs
+int *lastCore = NULL;                                           // CPU each process last ran on (-1 if none)
+int numCoreThreads = 1;                                         // Threads running the simulated CPUs
+pthread_barrier_t coreBarrier;                                  // Starts and ends each phase on every simulation thread
+CorePhase corePhase = CORE_PHASE_RUN;                           // Phase the simulation threads run next
+int coreStepTime = 0;                                           // Start of the slice of the current step
+int coreStepSlice = 0;                                          // Length of the slice of the current step
+bool printProcessResults = true;                                // Print a results line for every process
 
 // Function prototypes
-void sortByArrival(Process proc[], int n);
-int findShortestJob(Process proc[], int n, int currentTime);
+void sortByArrival(int n);
 void *processThread(void *arg);
-void *schedulerThread(void *arg);
-void printResults(Process proc[], int n);
-void printGanttChart(GanttEntry gantt[], int size);
-void updateProcessStates(Process proc[], int n, int currentTime, int runningIdx);
-void printProcessTable(Process proc[], int n, int currentTime);
+void *workerThread(void *arg);
+void *lockFreeWorkerThread(void *arg);
+void runSlice(int idx, int slice);
+void executeSlice(int idx, int start, int slice);
+bool advanceSlice(int idx, int start, int slice);
+void recordSlice(int idx, int start, int slice, bool completes);
+bool runMultiCoreSimulation(RunStats *stats);
+void *coreThread(void *arg);
+void runCorePhase(CorePhase phase);
+void runCoreRange(int thread, CorePhase phase);
+void coreSelectGlobal(void);
+void coreSelectLocal(SimCore *core);
+bool coreSteal(SimCore *thief);
+SimCore *coreLeastLoaded(void);
+void coreQueuePush(SimCore *core, int idx);
+void coreRunSlice(SimCore *core);
+void coreLogEvent(SimCore *core, int type, int time, int pid, int arg);
+void coreLogStep(void);
+void freeSimCores(void);
+void printCoreSummary(void);
+void printGanttLanes(void);
+void printGanttBars(GanttLog *log);
+void dispatchLockFree(int idx, int slice);
+void drainCompletions(LockFreeWorker *worker);
+void waitForWorker(LockFreeWorker *worker);
+bool ringPush(SpscRing *ring, SliceRecord record);
+bool ringPop(SpscRing *ring, SliceRecord *record);
+void ringInit(SpscRing *ring);
+void ringDestroy(SpscRing *ring);
+void ringWait(SpscRing *ring, bool forRoom);
+void ringWake(SpscRing *ring);
+bool runSimulation(RunStats *stats);
+void printResults(int n);
+void printMetricDistribution(const MetricStats *stats);
+bool statsShardsInit(int shards);
+void statsShardsMerge(MetricStats *into);
+void printGanttChart(GanttLog *log);
+void printGantt(GanttLog *const lanes[], int count);
+int terminalWidth(void);
 const char* getStateName(ProcessState state);
-
-int main() {
+int formatTimelineEvent(const EventRecord *record, char *buf, size_t size);
+const SchedulingPolicy *findPolicy(const char *name);
+bool parseArguments(int argc, char *argv[]);
+void printUsage(const char *program);
+int computeSliceLength(int idx, int nextToArrive, int used);
+double elapsedSeconds(struct timespec start, struct timespec end);
+void realtimeDelay(int units);
+void printSimulationSpeed(int ticks, const RunStats *stats);
+long contextSwitchCount(void);
+void wakeDispatchedThread(int idx);
+bool arenaInit(Arena *arena, size_t capacity);
+void *arenaAlloc(Arena *arena, size_t size);
+void arenaFree(Arena *arena);
+void printMemoryUsage(Arena *arena, GanttLog *const lanes[], int count);
+bool allocateProcessTable(int n);
+void resetProcess(int i);
+int readProcessesInteractively(void);
+int loadProcessesFromTrace(const char *path);
+int mapProcessesFromBinaryTrace(const char *path);
+int nextArrivalTime(int nextToArrive);
+bool hasNextArrival(int nextToArrive);
+int runStreamingSimulation(void);
+bool streamGrowTable(int capacity);
+void streamReadNext(void);
+int streamAdmit(long sequence);
+void streamRetire(int idx);
+
+int main(int argc, char *argv[]) {
     // Variable declarations
     // n if for number of processes 
-    // i for loop iteration
-    int n, i;
+    int n;
+
+    // Read command-line options before prompting for input
+    if (!parseArguments(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    instrStart();
 
     printf("======================================\n");
-    printf("  SRTF Process Scheduling Simulator\n");
+    printf("  %s Process Scheduling Simulator\n", policy->label);
     printf("  (Multithreaded Implementation)\n");
     printf("======================================\n\n");
+
+    // Streams are simulated while they are read
+    if (streamMode) {
+        return runStreamingSimulation();
+    }
+    
+    // Read the workload from a trace file, or prompt for it
+    n = traceFile != NULL ? loadProcessesFromTrace(traceFile) : readProcessesInteractively();
+    if (n < 0) {
+        return 1;
+    }
+
+    // Set global number of processes
+    numProcesses = n;
+
+    // Sort processes by arrival time
+    // (a sorted binary trace is already in order and is filled in lazily)
+    if (populatedProcesses == n) {
+        sortByArrival(n);
+    }
+
+    // Processes enter the ready queue as the scheduler reaches their Arrival Time
+    readyQueueInit(&readyQueue, processes.queueKey, processes.sequence, n, readyHeap, readyPos);
+
+    if (printTimeline) {
+        printf("\n======================================\n");
+        printf("  Execution Timeline (%s)\n", policy->mode);
+        printf("======================================\n");
+        printf(policy->note, timeQuantum);
+        if (numCpus > 0) {
+            printf("Multi-core: %d simulated CPUs, %s; each step's\n", numCpus,
+                   queueMode == QUEUES_GLOBAL ? "one global ready queue" : "a ready queue per CPU");
+            printf("            slices run in parallel on the simulation threads.\n\n");
+        } else if (lockFreeHandoff) {
+            printf("Multithreading: Processes run on %d worker threads, fed through\n", numWorkers);
+            printf("                lock-free rings by the scheduler thread.\n\n");
+        } else if (numWorkers > 0) {
+            printf("Multithreading: Processes run as tasks on a pool of %d worker\n", numWorkers);
+            printf("                threads, coordinated by the scheduler thread.\n\n");
+        } else {
+            printf("Multithreading: Each process runs in its own thread,\n");
+            printf("                coordinated by the scheduler thread.\n\n");
+        }
+        printf("Process States: READY -> RUNNING -> COMPLETED\n\n");
+        if (eventDriven) {
+            printf("Event-driven: each RUNNING row covers the whole slice up to\n");
+            printf("              the next arrival or the process's completion.\n\n");
+        }
+    }
+
+    // Timeline rows are formatted and printed by the event log's writer thread,
+    // or written to the binary event log, off the scheduling critical section
+    if (printTimeline || eventLogFile != NULL) {
+        if (eventLogStart(&eventLog, eventLogFile == NULL ? formatTimelineEvent : NULL, stdout, eventLogFile) != 0) {
+            return 1;
+        }
+    }
+
+    // Run the simulation on the scheduler and process threads, or on the
+    // simulated CPUs
+    RunStats stats;
+    bool simulated = numCpus > 0 ? runMultiCoreSimulation(&stats) : runSimulation(&stats);
+    eventLogStop(&eventLog);
+    if (!simulated) {
+        return 1;
+    }
+
+    // Display results
+    printResults(n);
+
+    // Display the hot-path counters (only in a -DSRTF_INSTRUMENT build)
+    instrPrintSummary();
     
+    // Display Gantt chart (one lane per simulated CPU)
+    int laneCount = numCpus > 0 ? numCpus : 1;
+    GanttLog **lanes = malloc((size_t)laneCount * sizeof(GanttLog *));
+    if (lanes == NULL) {
+        fprintf(stderr, "Error allocating memory for %d Gantt lanes\n", laneCount);
+        return 1;
+    }
+    if (numCpus > 0) {
+        for (int c = 0; c < numCpus; c++) {
+            lanes[c] = &simCores[c].lane;
+        }
+        printCoreSummary();
+    } else {
+        lanes[0] = &gantt;
+    }
+    printGantt(lanes, laneCount);
+
+    // Export the Gantt log; the slices are decoded one at a time
+    if (ganttBinaryFile != NULL && ganttExportBinary(ganttBinaryFile, lanes, laneCount) != 0) {
+        return 1;
+    }
+    if (ganttTraceFile != NULL && ganttExportChromeTrace(ganttTraceFile, lanes, laneCount) != 0) {
+        return 1;
+    }
+    if (ganttSvgFile != NULL &&
+        ganttWriteSvg(ganttSvgFile, lanes, laneCount, ganttWidth > 0 ? ganttWidth : GANTT_SVG_WIDTH) != 0) {
+        return 1;
+    }
+
+    // Display how fast the simulation ran
+    printSimulationSpeed(globalCurrentTime, &stats);
+
+    // Display how much memory the process table and Gantt log used
+    printMemoryUsage(&processArena, lanes, laneCount);
+    free(lanes);
+    freeSimCores();
+
+    // Cleanup
+    pthread_mutex_destroy(&schedulerMutex);
+    pthread_cond_destroy(&schedulerCond);
+    pthread_cond_destroy(&sliceDoneCond);
+    ganttFree(&gantt);
+    arenaFree(&processArena);
+    traceUnmap(&mappedTrace);
+
+    return 0;
+}
+
+// Run one simulation of processes[0..numProcesses-1] to completion on the
+// scheduler thread plus the process, pool or lock-free worker threads
+// Returns false if a thread could not be created
+bool runSimulation(RunStats *stats) {
+    int n = numProcesses;
+    int i;
+
+    // Create pthread_t variable for scheduler
+    pthread_t scheduler;
+
+    // Each process thread sleeps on its own condition variable, so the
+    // scheduler can wake exactly the one it dispatches
+    bool perProcessConds = !lockFreeHandoff && numWorkers == 0 && !broadcastWakeups;
+    if (perProcessConds) {
+        for (i = 0; i < n; i++) {
+            pthread_cond_init(&processes.wakeCond[i], NULL);
+        }
+    }
+
+    // Wall-clock timing, context switches and cache misses for the simulation
+    // speed report; the counter is opened before any simulation thread exists
+    // so it covers all of them
+    struct timespec runStart, runEnd;
+    PerfCounter cacheMissCounter;
+    perfCounterOpen(&cacheMissCounter, PERF_COUNT_HW_CACHE_MISSES);
+    schedulingDecisions = 0;
+
+    // One metric shard per worker; process threads share one per core, taking
+    // turns since only the dispatched thread runs
+    int shards = numWorkers;
+    if (shards == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        shards = cores > 0 && cores < n ? (int)cores : n;
+    }
+    if (!statsShardsInit(shards)) {
+        fprintf(stderr, "Error allocating statistics for %d threads\n", shards);
+        return false;
+    }
+    long switchesBefore = contextSwitchCount();
+    clock_gettime(CLOCK_MONOTONIC, &runStart);
+    perfCounterStart(&cacheMissCounter);
+
+    // Create process threads and runs the processes via processThread function
+    // or, in pool mode, a fixed number of worker threads that run any process
+    // Checks if each thread is created successfully
+    pthread_t *workers = NULL;
+    if (lockFreeHandoff) {
+        // Rings contain cache-line aligned indices, so the workers need aligned storage
+        void *storage = NULL;
+        if (posix_memalign(&storage, CACHE_LINE, (size_t)numWorkers * sizeof(LockFreeWorker)) != 0) {
+            fprintf(stderr, "Error allocating worker threads\n");
+            return false;
+        }
+        lockFreeWorkers = storage;
+        for (i = 0; i < numWorkers; i++) {
+            ringInit(&lockFreeWorkers[i].dispatch);
+            ringInit(&lockFreeWorkers[i].completion);
+            lockFreeWorkers[i].dispatched = 0;
+            lockFreeWorkers[i].completed = 0;
+        }
+        for (i = 0; i < numWorkers; i++) {
+            if (pthread_create(&lockFreeWorkers[i].thread, NULL, lockFreeWorkerThread, &lockFreeWorkers[i]) != 0) {
+                fprintf(stderr, "Error creating worker thread %d\n", i + 1);
+                return false;
+            }
+        }
+    } else if (numWorkers > 0) {
+        workers = malloc((size_t)numWorkers * sizeof(pthread_t));
+        if (workers == NULL) {
+            fprintf(stderr, "Error allocating worker threads\n");
+            return false;
+        }
+        for (i = 0; i < numWorkers; i++) {
+            if (pthread_create(&workers[i], NULL, workerThread, (void *)(intptr_t)i) != 0) {
+                fprintf(stderr, "Error creating worker thread %d\n", i + 1);
+                return false;
+            }
+        }
+    } else {
+        for (i = 0; i < n; i++) {
+            if (pthread_create(&processes.thread[i], NULL, processThread, (void *)(intptr_t)i) != 0) {
+                fprintf(stderr, "Error creating process thread %d\n", i + 1);
+                return false;
+            }
+        }
+    }
+
+    // Creates and runs the scheduler thread
+    // Checks if there is an error when creating the scheduler thread
+    // It starts last, so every worker it may dispatch to already exists
+    if (pthread_create(&scheduler, NULL, policy->schedulerThread, NULL) != 0) {
+        fprintf(stderr, "Error creating scheduler thread\n");
+        return false;
+    }
+
+    // When a process a been scheduled, executed, and completed,
+    // that process's thread will finish.
+    // Hence, when all processes are done, then only the scheduler thread will finish.
+    // When scheduler is done, the scheduler thread will join back to the main thread
+    pthread_join(scheduler, NULL);
+
+    // Joins all process (or worker) threads back to main thread
+    if (lockFreeHandoff) {
+        for (i = 0; i < numWorkers; i++) {
+            pthread_join(lockFreeWorkers[i].thread, NULL);
+            ringDestroy(&lockFreeWorkers[i].dispatch);
+            ringDestroy(&lockFreeWorkers[i].completion);
+        }
+        free(lockFreeWorkers);
+        lockFreeWorkers = NULL;
+    } else if (numWorkers > 0) {
+        for (i = 0; i < numWorkers; i++) {
+            pthread_join(workers[i], NULL);
+        }
+        free(workers);
+    } else {
+        for (i = 0; i < n; i++) {
+            pthread_join(processes.thread[i], NULL);
+        }
+    }
+    stats->cacheMisses = perfCounterStop(&cacheMissCounter);
+    perfCounterClose(&cacheMissCounter);
+    clock_gettime(CLOCK_MONOTONIC, &runEnd);
+    stats->seconds = elapsedSeconds(runStart, runEnd);
+    stats->contextSwitches = contextSwitchCount() - switchesBefore;
+    stats->decisions = schedulingDecisions;
+
+    // Every thread has finished writing its shard
+    statsShardsMerge(&metricStats);
+
+    if (perProcessConds) {
+        for (i = 0; i < n; i++) {
+            pthread_cond_destroy(&processes.wakeCond[i]);
+        }
+    }
+    return true;
+}
+
+// Prompt for the number of processes and each process's Arrival and Burst Time
+// Returns the number of processes, or -1 if memory could not be allocated
+int readProcessesInteractively(void) {
+    int n, i;
+
     // Input validation for number of processes
     do {
-        printf("Enter number of processes (1-%d): ", MAX_PROC);
+        printf("Enter number of processes (at least 1): ");
 
         // Check for valid integer input
         if (scanf("%d", &n) != 1) {
@@ -105,406 +658,1767 @@ int main() {
         }
 
         // Check user input range
-        if (n < 1 || n > MAX_PROC) {
-            printf("Invalid number! Must be between 1 and %d.\n", MAX_PROC);
+        if (n < 1) {
+            printf("Invalid number! Must be at least 1.\n");
         }
 
     // Repeat until valid input is received
-    } while (n < 1 || n > MAX_PROC);
+    } while (n < 1);
 
-    // Set global number of processes
-    numProcesses = n;
+    // Allocate the Process table for n processes
+    if (!allocateProcessTable(n)) {
+        return -1;
+    }
 
     // Input arrival and burst times with validation
     printf("\nEnter arrival and burst times:\n");
 
     // Loop to get each process's Arrival Time and Burst Time
     for (i = 0; i < n; i++) {
-        processes[i].pid = i + 1;
+        processes.pid[i] = i + 1;
         
         // Arrival time input validation
         do {
             printf("Process %d - Arrival Time: ", i + 1);
 
             // Check for valid integer input
-            if (scanf("%d", &processes[i].arrivalTime) != 1) {
+            if (scanf("%d", &processes.arrivalTime[i]) != 1) {
                 while (getchar() != '\n');
                 printf("Invalid input! Please enter a valid integer.\n");
-                processes[i].arrivalTime = -1;
+                processes.arrivalTime[i] = -1;
                 continue;
             }
 
             // Print warning if Arrival Time is invalid
-            if (processes[i].arrivalTime < 0) {
+            if (processes.arrivalTime[i] < 0) {
                 printf("Arrival time cannot be negative!\n");
             }
 
         // Repeat until valid input is received
-        } while (processes[i].arrivalTime < 0);
+        } while (processes.arrivalTime[i] < 0);
 
         // Burst time input validation
         do {
             printf("Process %d - Burst Time:   ", i + 1);
 
             // Check for valid integer input
-            if (scanf("%d", &processes[i].burstTime) != 1) {
+            if (scanf("%d", &processes.burstTime[i]) != 1) {
                 while (getchar() != '\n');
                 printf("Invalid input! Please enter a valid integer.\n");
-                processes[i].burstTime = 0;
+                processes.burstTime[i] = 0;
                 continue;
             }
 
             // Print warning if Burst Time is invalid
-            if (processes[i].burstTime < 1) {
+            if (processes.burstTime[i] < 1) {
                 printf("Burst time must be at least 1!\n");
             }
         
         // Repeat until valid input is received
-        } while (processes[i].burstTime < 1);
+        } while (processes.burstTime[i] < 1);
 
         // Initialise process fields
-        processes[i].remainingTime = processes[i].burstTime;
-        processes[i].startTime = -1;
-        processes[i].completionTime = 0;
-        processes[i].turnaroundTime = 0;
-        processes[i].waitingTime = 0;
-        processes[i].responseTime = 0;
-        processes[i].finished = 0;
-        processes[i].hasStarted = 0;
-        processes[i].state = READY; 
+        processes.priority[i] = 0;
+        resetProcess(i);
     }
 
-    // Sort processes by arrival time
-    sortByArrival(processes, n);
+    populatedProcesses = n;
+    return n;
 
-    printf("\n======================================\n");
-    printf("  Execution Timeline (PREEMPTIVE)\n");
-    printf("======================================\n");
-    printf("Note: SRTF allows preemption - processes can be interrupted\n");
-    printf("      when a shorter job arrives.\n");
-    printf("Multithreading: Each process runs in its own thread,\n");
-    printf("                coordinated by the scheduler thread.\n\n");
-    printf("Process States: READY -> RUNNING -> COMPLETED\n\n");
+}
 
-    // Create pthread_t variable for scheduler
-    pthread_t scheduler;
+// Load every process from a trace file (see trace_reader.h for the format)
+// Returns the number of processes, or -1 on error
+int loadProcessesFromTrace(const char *path) {
+    Trace trace;
 
-    // Creates and runs the scheduler thread
-    // Checks if there is an error when creating the scheduler thread
-    if (pthread_create(&scheduler, NULL, schedulerThread, NULL) != 0) {
-        fprintf(stderr, "Error creating scheduler thread\n");
+    // Sorted binary traces are mapped rather than read
+    if (traceIsBinary(path)) {
+        int n = mapProcessesFromBinaryTrace(path);
+        if (n != 0) return n;
+    }
+
+    int n = traceLoad(path, &trace);
+    if (n < 0) {
+        return -1;
+    }
+
+    if (!allocateProcessTable(n)) {
+        traceFree(&trace);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        processes.pid[i] = trace.records[i].pid;
+        processes.arrivalTime[i] = trace.records[i].arrivalTime;
+        processes.burstTime[i] = trace.records[i].burstTime;
+        processes.priority[i] = trace.records[i].priority;
+        resetProcess(i);
+    }
+
+    traceFree(&trace);
+    populatedProcesses = n;
+    printf("Loaded %d processes from %s\n", n, path);
+    return n;
+}
+
+// Map a binary trace and leave the Process table to be filled in lazily by
+// nextArrivalTime() as the scheduler reaches each arrival
+// Returns the number of processes, -1 on error, or 0 if the trace is not
+// sorted by arrival (it is then loaded and sorted like a text trace)
+int mapProcessesFromBinaryTrace(const char *path) {
+    if (traceMap(path, &mappedTrace) != 0) {
+        return -1;
+    }
+    if (!(mappedTrace.flags & TRACE_BINARY_SORTED)) {
+        traceUnmap(&mappedTrace);
+        return 0;
+    }
+
+    int n = mappedTrace.count;
+    if (!allocateProcessTable(n)) {
+        traceUnmap(&mappedTrace);
+        return -1;
+    }
+
+    populatedProcesses = 0;
+    printf("Mapped %d processes from %s\n", n, path);
+    return n;
+}
+
+// Simulate a text trace while reading it (--stream)
+// Processes enter the Process table as the scheduler reaches their Arrival
+// Time and leave it when they finish, after their results are printed
+// Returns the exit status
+int runStreamingSimulation(void) {
+    const char *path = traceFile != NULL ? traceFile : "-";
+    if (traceIsBinary(path)) {
+        fprintf(stderr, "--stream reads text traces; %s is a binary trace\n", path);
         return 1;
     }
 
-    // Create process threads and runs the processes via processThread function
-    // Checks if each thread is created successfully
-    for (i = 0; i < n; i++) {
-        if (pthread_create(&processes[i].thread, NULL, processThread, &processes[i]) != 0) {
-            fprintf(stderr, "Error creating process thread %d\n", i + 1);
+    memset(&stream, 0, sizeof(stream));
+    if (traceOpen(&stream.reader, path) != 0) {
+        return 1;
+    }
+    if (!streamGrowTable(STREAM_INITIAL_SLOTS)) {
+        fprintf(stderr, "Error allocating memory for %d processes\n", STREAM_INITIAL_SLOTS);
+        traceClose(&stream.reader);
+        return 1;
+    }
+    readyQueueInit(&readyQueue, processes.queueKey, processes.sequence, stream.capacity, readyHeap, readyPos);
+    numProcesses = 0;
+    streamReadNext();
+
+    printf("Streaming processes from %s on %d worker threads\n",
+           strcmp(path, "-") == 0 ? "stdin" : path, numWorkers);
+    printf("\n======================================\n");
+    printf("  Scheduling Results\n");
+    printf("======================================\n\n");
+
+    if (eventLogFile != NULL) {
+        if (eventLogStart(&eventLog, NULL, stdout, eventLogFile) != 0) {
             return 1;
         }
     }
 
-    // When a process a been scheduled, executed, and completed,
-    // that process's thread will finish.
-    // Hence, when all processes are done, then only the scheduler thread will finish.
-    // When scheduler is done, the scheduler thread will join back to the main thread
-    pthread_join(scheduler, NULL);
+    // Results are printed by the scheduler thread as processes finish
+    RunStats stats;
+    bool simulated = runSimulation(&stats);
+    eventLogStop(&eventLog);
+    traceClose(&stream.reader);
+    if (!simulated) {
+        return 1;
+    }
 
-    // Joins all process threads back to main thread
-    for (i = 0; i < n; i++) {
-        pthread_join(processes[i].thread, NULL);
+    if (metricStats.turnaround.count > 0) {
+        printf("\nAverage Turnaround Time = %.2f\n", onlineStatsMean(&metricStats.turnaround));
+        printf("Average Waiting Time = %.2f\n", onlineStatsMean(&metricStats.waiting));
+        printf("Average Response Time = %.2f\n", onlineStatsMean(&metricStats.response));
+        printMetricDistribution(&metricStats);
     }
+    instrPrintSummary();
 
-    // Display results
-    printResults(processes, n);
-    
-    // Display Gantt chart
-    printGanttChart(gantt, ganttSize);
+    printSimulationSpeed(globalCurrentTime, &stats);
+
+    // Memory held by the table: its size is set by the peak number of live processes
+    size_t perRow = 3 * sizeof(int);
+#define COLUMN_SIZE(field) perRow += sizeof(*processes.field);
+    PROCESS_COLUMNS(COLUMN_SIZE)
+#undef COLUMN_SIZE
+    printf("\n======================================\n");
+    printf("  Memory Usage\n");
+    printf("======================================\n\n");
+    printf("Processes streamed   = %lld\n", metricStats.turnaround.count);
+    printf("Peak live processes  = %d\n", stream.peakLive);
+    printf("Process table        = %zu bytes (%d rows)\n", (size_t)stream.capacity * perRow, stream.capacity);
 
     // Cleanup
+#define COLUMN_FREE(field) free(processes.field);
+    PROCESS_COLUMNS(COLUMN_FREE)
+#undef COLUMN_FREE
+    free(readyHeap);
+    free(readyPos);
+    free(stream.freeRows);
     pthread_mutex_destroy(&schedulerMutex);
     pthread_cond_destroy(&schedulerCond);
+    pthread_cond_destroy(&sliceDoneCond);
 
-    return 0;
+    return stream.failed ? 1 : 0;
+}
+
+// Grow the streaming Process table and ready queue arrays to capacity rows
+// Only called by the scheduler between slices, when no worker is using the table
+// Returns false if memory could not be allocated
+bool streamGrowTable(int capacity) {
+#define COLUMN_GROW(field)                                                                   \
+    {                                                                                        \
+        void *column = realloc(processes.field, (size_t)capacity * sizeof(*processes.field)); \
+        if (column == NULL) return false;                                                    \
+        processes.field = column;                                                            \
+    }
+    PROCESS_COLUMNS(COLUMN_GROW)
+#undef COLUMN_GROW
+    int *heap = realloc(readyHeap, (size_t)capacity * sizeof(int));
+    if (heap == NULL) return false;
+    readyHeap = heap;
+    int *pos = realloc(readyPos, (size_t)capacity * sizeof(int));
+    if (pos == NULL) return false;
+    readyPos = pos;
+    int *freeRows = realloc(stream.freeRows, (size_t)capacity * sizeof(int));
+    if (freeRows == NULL) return false;
+    stream.freeRows = freeRows;
+
+    // The new rows are free and not queued; the lowest is handed out first
+    for (int i = capacity - 1; i >= stream.capacity; i--) {
+        readyPos[i] = -1;
+        stream.freeRows[stream.freeCount++] = i;
+    }
+    stream.capacity = capacity;
+
+    // The ready queue points into the columns, which may have moved
+    readyQueue.key = processes.queueKey;
+    readyQueue.sequence = processes.sequence;
+    readyQueue.heap = readyHeap;
+    readyQueue.pos = readyPos;
+    return true;
+}
+
+// Read the next process of the trace into stream.next
+// A malformed line, or a process arriving before the previous one, ends the
+// stream there; the processes read so far are still simulated
+void streamReadNext(void) {
+    int previousArrival = stream.hasNext ? stream.next.arrivalTime : 0;
+
+    int status = traceNext(&stream.reader, &stream.next);
+    stream.hasNext = status == 1;
+    if (status < 0) {
+        stream.failed = true;
+    }
+    if (stream.hasNext && stream.next.arrivalTime < previousArrival) {
+        traceError(&stream.reader, "process arrives before the previous one (--stream needs arrival order)");
+        stream.hasNext = false;
+        stream.failed = true;
+    }
+}
+
+// Move stream.next into a free row of the Process table and read the
+// process after it
+// sequence is the process's position in the trace
+// Returns the row
+int streamAdmit(long sequence) {
+    if (stream.freeCount == 0) {
+        // Lock-free workers may still be recording slices in the columns
+        // that are about to move
+        if (lockFreeHandoff) {
+            for (int i = 0; i < numWorkers; i++) waitForWorker(&lockFreeWorkers[i]);
+        }
+        if (!streamGrowTable(2 * stream.capacity)) {
+            fprintf(stderr, "Error allocating memory for %d live processes\n", 2 * stream.capacity);
+            exit(1);
+        }
+    }
+
+    int row = stream.freeRows[--stream.freeCount];
+    processes.pid[row] = stream.next.pid;
+    processes.arrivalTime[row] = stream.next.arrivalTime;
+    processes.burstTime[row] = stream.next.burstTime;
+    processes.priority[row] = stream.next.priority;
+    processes.sequence[row] = sequence;
+    resetProcess(row);
+
+    stream.live++;
+    if (stream.live > stream.peakLive) stream.peakLive = stream.live;
+
+    streamReadNext();
+    return row;
+}
+
+// Print the results of a finished process and free its row
+// (runSlice has already added them to the metric summaries)
+void streamRetire(int idx) {
+    if (printProcessResults) {
+        printf("Process P%d: Turnaround = %d, Waiting = %d, Response = %d\n",
+               processes.pid[idx],
+               processes.turnaroundTime[idx],
+               processes.waitingTime[idx],
+               processes.responseTime[idx]);
+    }
+
+    stream.live--;
+    stream.freeRows[stream.freeCount++] = idx;
+}
+
+// Allocate the Process table columns and ready queue arrays for n processes
+// One arena allocation holds them all (each rounded up to ARENA_ALIGNMENT,
+// hence the extra slack)
+bool allocateProcessTable(int n) {
+    size_t perProcess = 2 * sizeof(int);
+    size_t columns = 2;
+#define COLUMN_SIZE(field) perProcess += sizeof(*processes.field); columns++;
+    PROCESS_COLUMNS(COLUMN_SIZE)
+#undef COLUMN_SIZE
+
+    size_t arenaSize = (size_t)n * perProcess + columns * ARENA_ALIGNMENT;
+    if (!arenaInit(&processArena, arenaSize)) {
+        fprintf(stderr, "Error allocating memory for %d processes\n", n);
+        return false;
+    }
+#define COLUMN_ALLOC(field) processes.field = arenaAlloc(&processArena, (size_t)n * sizeof(*processes.field));
+    PROCESS_COLUMNS(COLUMN_ALLOC)
+#undef COLUMN_ALLOC
+    readyHeap = arenaAlloc(&processArena, (size_t)n * sizeof(int));
+    readyPos = arenaAlloc(&processArena, (size_t)n * sizeof(int));
+    return true;
+}
+
+// Initialise the scheduling fields of a process whose pid, Arrival Time
+// and Burst Time have been set
+void resetProcess(int i) {
+    processes.remainingTime[i] = processes.burstTime[i];
+    processes.startTime[i] = -1;
+    processes.completionTime[i] = 0;
+    processes.turnaroundTime[i] = 0;
+    processes.waitingTime[i] = 0;
+    processes.responseTime[i] = 0;
+    processes.finished[i] = 0;
+    processes.hasStarted[i] = 0;
+    processes.state[i] = READY;
 }
 
-// Scheduler thread function to coordinate the process execution
-void *schedulerThread(void *arg) {
+// Scheduler loop to coordinate the process execution
+// Never called through a pointer: DEFINE_SCHEDULER_LOOP instantiates it once
+// per policy with that policy's hooks as constants, and always inlining the
+// body lets the compiler turn each hook into a direct (usually inlined) call,
+// so no tick of the loop goes through the SchedulingPolicy table
+static inline __attribute__((always_inline))
+void schedulerLoop(long (*onArrival)(int idx), long (*onPreempt)(int idx),
+                   bool (*shouldPreempt)(int running, int candidate, int used), bool usesQuantum) {
     int lastProcess = -1;
-    // Track which processes have printed arrival
-    bool processArrivalPrinted[MAX_PROC] = {false};  
+    // Index of the next process to arrive (processes[] is sorted by Arrival Time)
+    int nextToArrive = 0;
+    // Process holding the CPU (kept out of the ready queue) and its time so far
+    PolicyState cpu = {-1, 0, false};
+    // Processes that have finished; only this thread counts them
+    int completed = 0;
 
     // Checks if there is at least one process and if the first process arrives after time 0
     // If condition returns true, jump to first Arrival Time
-    if (numProcesses > 0 && processes[0].arrivalTime > 0) {
-        pthread_mutex_lock(&schedulerMutex);
-        globalCurrentTime = processes[0].arrivalTime;
-        pthread_mutex_unlock(&schedulerMutex);
+    if (hasNextArrival(0) && nextArrivalTime(0) > 0) {
+        globalCurrentTime = nextArrivalTime(0);
     }
 
+    // This thread logs every arrival, so give it a large event ring
+    eventLogRegisterThread(&eventLog, EVENT_RING_LARGE);
+    instrThreadStart(INSTR_ROLE_SCHEDULER);
+
     // Print table header
-    printf("%-6s %-12s %-12s %-15s %-10s\n", 
-           "Time", "Process ID", "Status", "Remaining Time", "Thread ID");
-    printf("--------------------------------------------------------------------------------\n");
+    if (printTimeline) {
+        printf("%-6s %-12s %-12s %-15s %-10s\n", 
+               "Time", "Process ID", "Status", "Remaining Time", "Thread ID");
+        printf("--------------------------------------------------------------------------------\n");
+    }
 
     // Runs loop while there are still processes with time remaining
+    // With the lock-free handoff only this thread touches the scheduling state
+    // between dispatches, so the mutex is not needed
     while (schedulerRunning) {
-        pthread_mutex_lock(&schedulerMutex);
-
-        // Check for process arrivals and print READY status
-        for (int i = 0; i < numProcesses; i++) {
-            if (processes[i].arrivalTime == globalCurrentTime && !processArrivalPrinted[i]) {
-                char pidStr[10];
-                sprintf(pidStr, "P%d", processes[i].pid);
-                printf("%-6d %-12s %-12s %-15d %-10s\n", 
-                       globalCurrentTime,
-                       pidStr,
-                       "READY",
-                       processes[i].remainingTime,
-                       "-");
-                processArrivalPrinted[i] = true;
+        if (!lockFreeHandoff) instrMutexLock(&schedulerMutex);
+
+        // Admit every process that has arrived by now into the ready queue
+        // and print its READY status
+        // When streaming, each arrival is read from the trace into a free row
+        while (hasNextArrival(nextToArrive) && nextArrivalTime(nextToArrive) <= globalCurrentTime) {
+            int row = streamMode ? streamAdmit(nextToArrive) : nextToArrive;
+            eventLogAppend(&eventLog, EVENT_READY, processes.arrivalTime[row],
+                           processes.pid[row], processes.remainingTime[row]);
+            if (scanSelection) {
+                processes.queueKey[row] = onArrival(row);
+            } else {
+                policyAdmit(&readyQueue, processes.queueKey, row, onArrival);
             }
+            nextToArrive++;
         }
 
-        // Check if all processes completed
+        // Check if all processes completed (for a stream: the trace has
+        // ended and every process read from it has finished)
         // If true, set loop iteration condition to false
-        if (globalCompleted >= numProcesses) {
+        if (streamMode ? !stream.hasNext && stream.live == 0 : completed >= numProcesses) {
             schedulerRunning = false;
+            if (lockFreeHandoff) {
+                // Once a worker has run everything dispatched to it, a record
+                // with idx -1 tells it to exit
+                SliceRecord stop = {-1, 0, 0, 0};
+                for (int i = 0; i < numWorkers; i++) {
+                    waitForWorker(&lockFreeWorkers[i]);
+                    while (!ringPush(&lockFreeWorkers[i].dispatch, stop)) {
+                        ringWait(&lockFreeWorkers[i].dispatch, true);
+                    }
+                }
+                break;
+            }
             pthread_cond_broadcast(&schedulerCond);
-            pthread_mutex_unlock(&schedulerMutex);
+            if (numWorkers == 0 && !broadcastWakeups) {
+                for (int i = 0; i < numProcesses; i++) {
+                    pthread_cond_signal(&processes.wakeCond[i]);
+                }
+            }
+            instrMutexUnlock(&schedulerMutex);
             break;
         }
 
-        // Find process with shortest remaining time
-        // Create variable to hold the index of the process's position in the array
-        int idx = findShortestJob(processes, numProcesses, globalCurrentTime);
-
-        // Update all process states before execution
-        updateProcessStates(processes, numProcesses, globalCurrentTime, idx);
+        // Let the policy decide whether the head of the ready queue (the
+        // shortest remaining time under SRTF) takes the CPU from the running
+        // process (policy_step.h)
+        int idx;
+        if (scanSelection) {
+            // Scan the admitted rows instead: the arg-min includes the running
+            // process, so it only changes hands to a strictly better candidate
+            idx = findShortestJob(&processes, nextToArrive, globalCurrentTime);
+            if (idx != cpu.running) {
+                // A finished process has already given up the CPU (running is -1)
+                if (cpu.running != -1) instrCount(INSTR_PREEMPTIONS);
+                cpu.used = 0;
+            }
+            cpu.running = idx;
+        } else {
+            idx = policyStep(&readyQueue, processes.queueKey, &cpu, onPreempt, shouldPreempt,
+                             usesQuantum, timeQuantum);
+            if (cpu.preempted) instrCount(INSTR_PREEMPTIONS);
+        }
 
         // If there exists no process with a shorter remaining time than the current process,
         // that means the process can execute up until next closest Arrival Time of another process.
         if (idx == -1) {
-            int nextArrival = __INT_MAX__;
-
-            // Iterate through the processes array to find the next closest Arrival Time
-            for (int i = 0; i < numProcesses; i++) {
-                if (!processes[i].finished && processes[i].arrivalTime > globalCurrentTime) {
-                    if (processes[i].arrivalTime < nextArrival) {
-                        nextArrival = processes[i].arrivalTime;
-                    }
-                }
-            }
-            
             // Checks if there exists a next Arrival Time
-            if (nextArrival != __INT_MAX__) {
-                // Add idle time to Gantt chart
-                if (ganttSize < MAX_TIMELINE) {
-                    gantt[ganttSize].pid = 0;
-                    gantt[ganttSize].startTime = globalCurrentTime;
-                    gantt[ganttSize].endTime = nextArrival;
-                    ganttSize++;
+            // (the next closest one belongs to the next process not yet admitted)
+            if (hasNextArrival(nextToArrive)) {
+                int nextArrival = nextArrivalTime(nextToArrive);
+
+                // Add idle time to Gantt chart (not kept when streaming)
+                if (!streamMode) {
+                    ganttAdd(&gantt, 0, globalCurrentTime, nextArrival);
                 }
 
                 // Prints the time the CPU does not have a process occupying it
                 // Sets the globalCurrentTime to the time of the next Arrival Time
-                printf("\n>>> Time %d-%d: CPU IDLE <<<\n\n", globalCurrentTime, nextArrival);
+                eventLogAppend(&eventLog, EVENT_IDLE, globalCurrentTime, 0, nextArrival);
                 globalCurrentTime = nextArrival;
+                instrCount(INSTR_IDLE_JUMPS);
             }
-            pthread_mutex_unlock(&schedulerMutex);
+            if (!lockFreeHandoff) instrMutexUnlock(&schedulerMutex);
             continue;
         }
 
         // Check for context switch (preemption)
-        if (lastProcess != -1 && lastProcess != processes[idx].pid) {
-            printf("\n>>> Time %d: **PREEMPTION** - Switching from P%d to P%d <<<\n\n", 
-                   globalCurrentTime, lastProcess, processes[idx].pid);
+        if (lastProcess != -1 && lastProcess != processes.pid[idx]) {
+            eventLogAppend(&eventLog, EVENT_PREEMPTION, globalCurrentTime, lastProcess, processes.pid[idx]);
         }
 
         // Set current process and signal it to execute
         globalCurrentProcess = idx;
+        globalSliceLength = computeSliceLength(idx, nextToArrive, cpu.used);
+        // (a lock-free worker may still be recording an earlier slice of it)
+        if (!lockFreeHandoff) processes.state[idx] = RUNNING;
         
-        // Add to Gantt chart
-        if (lastProcess == processes[idx].pid && ganttSize > 0) {
-            gantt[ganttSize - 1].endTime = globalCurrentTime + 1;
-        } 
-        else {
-            if (ganttSize < MAX_TIMELINE) {
-                gantt[ganttSize].pid = processes[idx].pid;
-                gantt[ganttSize].startTime = globalCurrentTime;
-                gantt[ganttSize].endTime = globalCurrentTime + 1;
-                ganttSize++;
+        // Add to Gantt chart; a process that keeps the CPU extends its last slice
+        // (when streaming only the last process is tracked)
+        if (!streamMode) {
+            ganttAdd(&gantt, processes.pid[idx], globalCurrentTime, globalCurrentTime + globalSliceLength);
+        }
+        lastProcess = processes.pid[idx];
+
+        int slice = globalSliceLength;
+        schedulingDecisions++;
+        instrCount(INSTR_DECISIONS);
+        if (lockFreeHandoff) {
+            // Publish the slice to a worker and carry on without waiting for it
+            dispatchLockFree(idx, slice);
+        } else {
+            // Wake up the selected process
+            wakeDispatchedThread(idx);
+
+            // Wait until the process has run its slice
+            // pthread_cond_wait releases the mutex so the process thread can proceed
+            while (globalCurrentProcess != -1) {
+                instrCondWait(&sliceDoneCond, &schedulerMutex);
             }
-            lastProcess = processes[idx].pid;
         }
 
-        // Wake up the selected process
-        pthread_cond_broadcast(&schedulerCond);
-        pthread_mutex_unlock(&schedulerMutex);
+        // A finished process frees the CPU; otherwise it keeps it until the
+        // policy preempts it on the next pass
+        // When streaming, its results are printed and its row freed right away,
+        // after a lock-free worker has recorded them
+        if (processes.finished[idx]) {
+            cpu.running = -1;
+            completed++;
+            if (streamMode) {
+                if (lockFreeHandoff) waitForWorker(&lockFreeWorkers[idx % numWorkers]);
+                streamRetire(idx);
+            }
+        } else {
+            cpu.used += slice;
+        }
+        if (!lockFreeHandoff) instrMutexUnlock(&schedulerMutex);
 
-        // Small delay to simulate time slice execution
-        // 100ms delay
-        usleep(100000); 
+        // Optional delay to watch the simulation in real time
+        // Scale 1 gives the original 100ms per time unit, larger scales run faster
+        if (realtimeScale > 0) {
+            realtimeDelay(slice);
+        }
     }
-
-    return NULL;
 }
 
+// Define NAME as a scheduler thread function running schedulerLoop() with
+// the given policy hooks
+#define DEFINE_SCHEDULER_LOOP(NAME, ON_ARRIVAL, ON_PREEMPT, SHOULD_PREEMPT, USES_QUANTUM) \
+    static void *NAME(void *arg) {                                                      \
+        (void)arg;                                                                      \
+        schedulerLoop(ON_ARRIVAL, ON_PREEMPT, SHOULD_PREEMPT, USES_QUANTUM);            \
+        return NULL;                                                                    \
+    }
+
 // Process thread function to represent the individual process execution
 void *processThread(void *arg) {
-    Process *proc = (Process *)arg;
+    // Position of this process in the Process table (differs from pid - 1 once sorted)
+    int idx = (int)(intptr_t)arg;
+    threadShard = &statsShards[idx % numStatsShards];
+    // Condition variable the scheduler signals when dispatching this process
+    pthread_cond_t *wakeCond = broadcastWakeups ? &schedulerCond : &processes.wakeCond[idx];
+    instrThreadStart(INSTR_ROLE_PROCESS);
 
     // While true loop that only breaks if either:
     // scheduler stops running 
     // or process is finished
     while (1) {
-        pthread_mutex_lock(&schedulerMutex);
+        instrMutexLock(&schedulerMutex);
 
         // Wait until this process is scheduled or scheduler stops
-        while (globalCurrentProcess != (proc->pid - 1) && schedulerRunning) {
-            pthread_cond_wait(&schedulerCond, &schedulerMutex);
+        // (with --wake=broadcast every dispatch wakes every process thread)
+        while (globalCurrentProcess != idx && schedulerRunning) {
+            instrCondWait(wakeCond, &schedulerMutex);
+            if (globalCurrentProcess != idx && schedulerRunning) instrCount(INSTR_SPURIOUS_WAKEUPS);
         }
 
         // Exit if scheduler stopped
         if (!schedulerRunning) {
-            pthread_mutex_unlock(&schedulerMutex);
+            instrMutexUnlock(&schedulerMutex);
             break;
         }
 
         // Check if process has arrived
-        if (proc->arrivalTime > globalCurrentTime) {
-            pthread_mutex_unlock(&schedulerMutex);
+        if (processes.arrivalTime[idx] > globalCurrentTime) {
+            instrCount(INSTR_SPURIOUS_WAKEUPS);
+            instrMutexUnlock(&schedulerMutex);
             continue;
         }
 
         // Exit if process is finished
-        if (proc->finished) {
-            pthread_mutex_unlock(&schedulerMutex);
+        if (processes.finished[idx]) {
+            instrMutexUnlock(&schedulerMutex);
             break;
         }
 
-        // Record Start Time for Response Time calculation
-        if (!proc->hasStarted) {
-            proc->startTime = globalCurrentTime;
-            proc->responseTime = proc->startTime - proc->arrivalTime;
-            proc->hasStarted = 1;
-        }
-
-        // Set state to RUNNING
-        proc->state = RUNNING;
-
-        // Print process execution in table format
-        char pidStr[10];
-            sprintf(pidStr, "P%d", proc->pid);
-            printf("%-6d %-12s %-12s %-15s %-10lu\n", 
-                   globalCurrentTime,
-                   pidStr,
-                   getStateName(proc->state),
-                   "0",
-                   (unsigned long)pthread_self());
-
-        // Decrement Remaining Time and Increment globalCurrentTime
-        proc->remainingTime--;
-        globalCurrentTime++;
-
-        // Check if process has completed
-        if (proc->remainingTime == 0) {
-            proc->completionTime = globalCurrentTime;
-            proc->turnaroundTime = proc->completionTime - proc->arrivalTime;
-            proc->waitingTime = proc->turnaroundTime - proc->burstTime;
-            proc->finished = 1;
-            proc->state = COMPLETED;
-            globalCompleted++;
-            
-            // Print completion status
-            char pidStr[10];
-            sprintf(pidStr, "P%d", proc->pid);
-            printf("%-6d %-12s %-12s %-15s %-10lu\n", 
-                   globalCurrentTime,
-                   pidStr,
-                   getStateName(proc->state),
-                   "0",
-                   (unsigned long)pthread_self());
-        } else {
-            // Set back to READY after execution
-            proc->state = READY;
-        }
+        // Execute the dispatched slice
+        runSlice(idx, globalSliceLength);
 
-        // Reset current process
+        // Reset current process and hand control back to the scheduler
         globalCurrentProcess = -1;
+        pthread_cond_signal(&sliceDoneCond);
 
-        pthread_mutex_unlock(&schedulerMutex);
+        instrMutexUnlock(&schedulerMutex);
     }
 
     return NULL;
 }
 
-// Update all process states based on current time and running process
-void updateProcessStates(Process proc[], int n, int currentTime, int runningIdx) {
-    for (int i = 0; i < n; i++) {
-        if (proc[i].finished) { proc[i].state = COMPLETED; } 
-        else if (i == runningIdx) { proc[i].state = RUNNING; } 
-        else if (proc[i].arrivalTime <= currentTime) { proc[i].state = READY; }
+// Number of time units processes[idx] runs before the scheduler decides again
+// Tick mode always runs one unit. Event-driven mode runs until the process
+// completes, or earlier if something could change the policy's choice: the
+// next arrival for preemptive policies (under SRTF the running process only
+// gets shorter in between), or the end of the quantum (used units spent) for
+// Round Robin.
+int computeSliceLength(int idx, int nextToArrive, int used) {
+    if (!eventDriven) return 1;
+
+    int slice = processes.remainingTime[idx];
+    if (policy->usesQuantum && timeQuantum - used < slice) {
+        slice = timeQuantum - used;
     }
-}
-
-// Get string representation of process state
-const char* getStateName(ProcessState state) {
-    switch(state) {
-        case READY: return "READY";
-        case RUNNING: return "RUNNING";
-        case COMPLETED: return "COMPLETED";
-        default: return "UNKNOWN";
+    if (policy->arrivalsPreempt && hasNextArrival(nextToArrive)) {
+        int untilArrival = nextArrivalTime(nextToArrive) - globalCurrentTime;
+        if (untilArrival < slice) slice = untilArrival;
     }
+    return slice;
 }
 
-// Sort processes by arrival time (improved bubble sort)
-// Added swapped flag for optimisation
-// Improved bubble sort runtime:
-// Best case: O(n)
-// Worst case: O(n^2)
-// Source: Algorithms, Data Structures and Efficiency module
-void sortByArrival(Process proc[], int n) {
-    int i, j;
-    bool swapped = true;
-
-    for (i = 0; i < n - 1 && swapped; i++) {
-        swapped = false;
+// True while a process is still to arrive: processes[nextToArrive] exists,
+// or when streaming, the trace has another record
+// Check this instead of comparing nextArrivalTime() with __INT_MAX__, which
+// is also a valid time (a process can complete at exactly INT_MAX)
+bool hasNextArrival(int nextToArrive) {
+    return streamMode ? stream.hasNext : nextToArrive < numProcesses;
+}
 
-        for (j = i + 1; j < n; j++) {
-            if (proc[i].arrivalTime > proc[j].arrivalTime) {
-                Process temp = proc[i];
-                proc[i] = proc[j];
-                proc[j] = temp;
-                swapped = true;
-            }
+// Arrival Time of processes[nextToArrive], or __INT_MAX__ once every process
+// has arrived (see hasNextArrival)
+// When the table comes from a sorted binary trace, this is where each entry is
+// filled in from the mapped columns, just before the scheduler first needs it
+// When streaming, it is the Arrival Time of the next process in the trace
+int nextArrivalTime(int nextToArrive) {
+    if (streamMode) return stream.hasNext ? stream.next.arrivalTime : __INT_MAX__;
+    if (nextToArrive >= numProcesses) return __INT_MAX__;
+
+    while (populatedProcesses <= nextToArrive) {
+        int i = populatedProcesses;
+        TraceRecord record;
+        // Each record is validated here, when it is first read
+        if (traceMappedRecord(&mappedTrace, i, &record) != 0) {
+            exit(1);
         }
+        processes.pid[i] = record.pid;
+        processes.arrivalTime[i] = record.arrivalTime;
+        processes.burstTime[i] = record.burstTime;
+        processes.priority[i] = record.priority;
+        processes.sequence[i] = i;
+        resetProcess(i);
+        populatedProcesses++;
     }
+    return processes.arrivalTime[nextToArrive];
 }
 
-// Find process with shortest Remaining Time that has arrived
-// If there exists such a process, its index is returned
-// If no such process exists, -1 is returned
-int findShortestJob(Process proc[], int n, int currentTime) {
-    int shortest = -1;
-    int minRemaining = __INT_MAX__;
-    
-    for (int i = 0; i < n; i++) {
-        if (!proc[i].finished && 
-            proc[i].arrivalTime <= currentTime && 
-            proc[i].remainingTime < minRemaining) {
-            minRemaining = proc[i].remainingTime;
-            shortest = i;
+// Parse command-line options
+// Returns false if an option is not recognised
+bool parseArguments(int argc, char *argv[]) {
+    policy = findPolicy("srtf");
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--event-driven") == 0) {
+            eventDriven = true;
+        } else if (strcmp(argv[i], "--pool") == 0) {
+            // One worker per online core
+            long cores = sysconf(_SC_NPROCESSORS_ONLN);
+            numWorkers = cores > 0 ? (int)cores : 1;
+        } else if (strncmp(argv[i], "--workers=", 10) == 0) {
+            char *end;
+            long workers = strtol(argv[i] + 10, &end, 10);
+            if (*end != '\0' || workers < 1 || workers > 4096) {
+                fprintf(stderr, "Invalid worker count: %s\n", argv[i] + 10);
+                return false;
+            }
+            numWorkers = (int)workers;
+        } else if (strcmp(argv[i], "--wake=broadcast") == 0) {
+            broadcastWakeups = true;
+        } else if (strcmp(argv[i], "--wake=targeted") == 0) {
+            broadcastWakeups = false;
+        } else if (strncmp(argv[i], "--policy=", 9) == 0) {
+            policy = findPolicy(argv[i] + 9);
+            if (policy == NULL) {
+                fprintf(stderr, "Unknown policy: %s\n", argv[i] + 9);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--quantum=", 10) == 0) {
+            char *end;
+            long quantum = strtol(argv[i] + 10, &end, 10);
+            if (*end != '\0' || quantum < 1 || quantum > 1000000) {
+                fprintf(stderr, "Invalid time quantum: %s\n", argv[i] + 10);
+                return false;
+            }
+            timeQuantum = (int)quantum;
+        } else if (strcmp(argv[i], "--select=scan") == 0) {
+            scanSelection = true;
+        } else if (strcmp(argv[i], "--select=heap") == 0) {
+            scanSelection = false;
+        } else if (strcmp(argv[i], "--summary") == 0) {
+            printProcessResults = false;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            printTimeline = false;
+        } else if (strncmp(argv[i], "--event-log=", 12) == 0) {
+            eventLogFile = argv[i] + 12;
+            printTimeline = false;
+        } else if (strncmp(argv[i], "--gantt-out=", 12) == 0) {
+            ganttBinaryFile = argv[i] + 12;
+        } else if (strncmp(argv[i], "--gantt-json=", 13) == 0) {
+            ganttTraceFile = argv[i] + 13;
+        } else if (strncmp(argv[i], "--gantt-svg=", 12) == 0) {
+            ganttSvgFile = argv[i] + 12;
+        } else if (strcmp(argv[i], "--gantt-width=full") == 0) {
+            ganttWidth = -1;
+        } else if (strncmp(argv[i], "--gantt-width=", 14) == 0) {
+            char *end;
+            long width = strtol(argv[i] + 14, &end, 10);
+            if (*end != '\0' || width < 10 || width > 100000) {
+                fprintf(stderr, "Invalid Gantt chart width: %s\n", argv[i] + 14);
+                return false;
+            }
+            ganttWidth = (int)width;
+        } else if (strcmp(argv[i], "--gantt-mode=pid") == 0) {
+            ganttUtilisation = false;
+        } else if (strcmp(argv[i], "--gantt-mode=util") == 0) {
+            ganttUtilisation = true;
+        } else if (strcmp(argv[i], "--handoff=lockfree") == 0) {
+            lockFreeHandoff = true;
+        } else if (strcmp(argv[i], "--handoff=mutex") == 0) {
+            lockFreeHandoff = false;
+        } else if (strncmp(argv[i], "--cpus=", 7) == 0) {
+            char *end;
+            long cpus = strtol(argv[i] + 7, &end, 10);
+            if (*end != '\0' || cpus < 1 || cpus > 4096) {
+                fprintf(stderr, "Invalid number of CPUs: %s\n", argv[i] + 7);
+                return false;
+            }
+            numCpus = (int)cpus;
+        } else if (strcmp(argv[i], "--queues=global") == 0) {
+            queueMode = QUEUES_GLOBAL;
+        } else if (strcmp(argv[i], "--queues=per-core") == 0) {
+            queueMode = QUEUES_PER_CORE;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            streamMode = true;
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            traceFile = argv[i] + 8;
+        } else if (strncmp(argv[i], "--realtime=", 11) == 0) {
+            char *end;
+            realtimeScale = strtod(argv[i] + 11, &end);
+            if (*end != '\0' || realtimeScale <= 0) {
+                fprintf(stderr, "Invalid real-time scale: %s\n", argv[i] + 11);
+                return false;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
         }
     }
-    
-    return shortest;
+
+    // The scan selects by Remaining Time, so it can only stand in for SRTF's ready queue
+    if (scanSelection && strcmp(policy->name, "srtf") != 0) {
+        fprintf(stderr, "--select=scan is only supported with --policy=srtf\n");
+        return false;
+    }
+
+    // The multi-core simulation runs SRTF on its own threads, one per host
+    // core (or --workers=K)
+    if (numCpus > 0) {
+        if (strcmp(policy->name, "srtf") != 0) {
+            fprintf(stderr, "--cpus is only supported with --policy=srtf\n");
+            return false;
+        }
+        if (scanSelection || streamMode || lockFreeHandoff) {
+            fprintf(stderr, "--cpus cannot be combined with --select=scan, --stream or --handoff=lockfree\n");
+            return false;
+        }
+    }
+
+    // A stream has no fixed set of processes to give threads to, so it runs
+    // on worker threads (one per core by default); per-process results are
+    // printed as processes finish, so the timeline only goes to --event-log
+    if (streamMode) {
+        if (scanSelection) {
+            fprintf(stderr, "--select=scan cannot be combined with --stream\n");
+            return false;
+        }
+        if (numWorkers == 0) {
+            long cores = sysconf(_SC_NPROCESSORS_ONLN);
+            numWorkers = cores > 0 ? (int)cores : 1;
+        }
+        printTimeline = false;
+    }
+
+    // The lock-free handoff always uses worker threads, one per core by default
+    if (lockFreeHandoff && numWorkers == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = cores > 0 ? (int)cores : 1;
+    }
+    return true;
+}
+
+// Print the supported command-line options
+void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --policy=NAME    Scheduling policy: srtf (default), sjf, fcfs, rr\n");
+    fprintf(stderr, "                   or priority (preemptive, lowest number first)\n");
+    fprintf(stderr, "  --quantum=Q      Round Robin time quantum (default 2)\n");
+    fprintf(stderr, "  --select=MODE    heap (default): keep waiting processes in a ready queue\n");
+    fprintf(stderr, "                   scan: SRTF only, scan the table with a SIMD arg-min\n");
+    fprintf(stderr, "  --event-driven   Run each process until the next arrival or its completion\n");
+    fprintf(stderr, "                   in one step instead of one time unit per step\n");
+    fprintf(stderr, "  --realtime=SCALE Pace the simulation for demos: 100ms per time unit / SCALE\n");
+    fprintf(stderr, "                   (default: no delay, run as fast as possible)\n");
+    fprintf(stderr, "  --pool           Run processes as tasks on one worker thread per core\n");
+    fprintf(stderr, "                   instead of creating a thread for every process\n");
+    fprintf(stderr, "  --workers=K      Like --pool, with K worker threads\n");
+    fprintf(stderr, "  --wake=MODE      targeted (default): wake only the dispatched thread\n");
+    fprintf(stderr, "                   broadcast: wake every thread on each dispatch\n");
+    fprintf(stderr, "  --handoff=MODE   mutex (default): dispatch under the scheduler mutex\n");
+    fprintf(stderr, "                   lockfree: dispatch through per-worker SPSC rings\n");
+    fprintf(stderr, "                   (uses --workers=K, default one worker per core)\n");
+    fprintf(stderr, "  --quiet          Do not print the execution timeline\n");
+    fprintf(stderr, "  --summary        Print only the averages and distribution of the\n");
+    fprintf(stderr, "                   results, not a line per process\n");
+    fprintf(stderr, "  --event-log=FILE Write the timeline as binary event records to FILE\n");
+    fprintf(stderr, "                   instead of printing it\n");
+    fprintf(stderr, "  --gantt-out=FILE Write the Gantt chart to FILE as compressed binary columns\n");
+    fprintf(stderr, "  --gantt-json=FILE Write the Gantt chart to FILE as Chrome trace-event JSON\n");
+    fprintf(stderr, "                   (chrome://tracing or Perfetto; 1 time unit = 1 us)\n");
+    fprintf(stderr, "  --gantt-svg=FILE Draw the Gantt chart to FILE as SVG (one column per pixel)\n");
+    fprintf(stderr, "  --gantt-width=W  Downsample the Gantt chart to W columns (default: terminal\n");
+    fprintf(stderr, "                   width once the run exceeds %d time units); full: always\n", GANTT_FULL_MAX_UNITS);
+    fprintf(stderr, "                   draw every slice at 4 characters per time unit\n");
+    fprintf(stderr, "  --gantt-mode=M   pid (default): each column shows the process that ran\n");
+    fprintf(stderr, "                   the longest; util: how busy the CPU was\n");
+    fprintf(stderr, "  --trace=FILE     Load processes from FILE instead of prompting\n");
+    fprintf(stderr, "                   (lines of: pid, arrival, burst[, priority]; - for stdin)\n");
+    fprintf(stderr, "                   Binary traces from trace_convert are memory-mapped\n");
+    fprintf(stderr, "  --cpus=M         SRTF only: simulate M CPUs, with one Gantt lane each;\n");
+    fprintf(stderr, "                   slices of the same step run in parallel on one thread\n");
+    fprintf(stderr, "                   per host core (or --workers=K)\n");
+    fprintf(stderr, "  --queues=MODE    global (default): the M shortest ready processes run\n");
+    fprintf(stderr, "                   per-core: a ready queue per CPU, arrivals go to the\n");
+    fprintf(stderr, "                   least loaded CPU and idle CPUs steal work\n");
+    fprintf(stderr, "  --stream         Read the text trace (--trace=FILE, default stdin) while\n");
+    fprintf(stderr, "                   simulating; it must be in arrival order. Results are\n");
+    fprintf(stderr, "                   printed as processes finish and only live processes\n");
+    fprintf(stderr, "                   are kept in memory (no Gantt chart)\n");
+}
+
+// Sleep for the given number of simulated time units at the --realtime pace
+// (100ms per unit / realtimeScale)
+// usleep is limited to 1,000,000 us and its count overflows for long slices
+// or small scales, so the delay is capped at REALTIME_MAX_DELAY seconds and
+// slept with nanosleep, resuming after signals
+void realtimeDelay(int units) {
+    double seconds = 0.1 * units / realtimeScale;
+    if (!(seconds < REALTIME_MAX_DELAY)) seconds = REALTIME_MAX_DELAY;
+
+    struct timespec delay, left;
+    delay.tv_sec = (time_t)seconds;
+    delay.tv_nsec = (long)((seconds - (double)delay.tv_sec) * 1e9);
+    while (nanosleep(&delay, &left) != 0 && errno == EINTR) {
+        delay = left;
+    }
+}
+
+// Seconds between two CLOCK_MONOTONIC readings
+double elapsedSeconds(struct timespec start, struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Print the achieved simulation speed
+void printSimulationSpeed(int ticks, const RunStats *stats) {
+    printf("\n======================================\n");
+    printf("  Simulation Speed\n");
+    printf("======================================\n\n");
+
+    printf("Simulated time units = %d\n", ticks);
+    printf("Wall-clock time      = %.6f s\n", stats->seconds);
+    if (stats->seconds > 0) {
+        printf("Ticks per second     = %.2f\n", ticks / stats->seconds);
+    }
+    printf("Context switches     = %ld", stats->contextSwitches);
+    if (ticks > 0) {
+        printf(" (%.2f per tick)", (double)stats->contextSwitches / ticks);
+    }
+    printf("\n");
+    printf("Scheduling decisions = %ld\n", stats->decisions);
+    if (stats->cacheMisses >= 0) {
+        printf("Cache misses         = %lld", stats->cacheMisses);
+        if (stats->decisions > 0) {
+            printf(" (%.2f per decision)", (double)stats->cacheMisses / stats->decisions);
+        }
+        printf("\n");
+    } else {
+        printf("Cache misses         = unavailable (no perf counter access)\n");
+    }
+}
+
+// Voluntary plus involuntary context switches of every thread in the process so far
+long contextSwitchCount(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+// Wake only the thread that will run processes[idx]: the process's own thread,
+// or a single pool worker
+// With --wake=broadcast every waiting thread is woken instead and all but one
+// go straight back to sleep, which is what the simulator used to do
+void wakeDispatchedThread(int idx) {
+    if (broadcastWakeups) {
+        pthread_cond_broadcast(&schedulerCond);
+    } else if (numWorkers > 0) {
+        pthread_cond_signal(&schedulerCond);
+    } else {
+        pthread_cond_signal(&processes.wakeCond[idx]);
+    }
+}
+
+// Execute the slice the scheduler dispatched to processes[idx]
+// Called by the process's own thread or a pool worker with schedulerMutex held
+void runSlice(int idx, int slice) {
+    // Advance globalCurrentTime by the slice
+    // (one tick, or a whole event-to-event slice in event-driven mode)
+    int start = globalCurrentTime;
+    globalCurrentTime = start + slice;
+    executeSlice(idx, start, slice);
+}
+
+// Run processes[idx] for slice time units starting at time start and record
+// its results if it completes
+// Shared by runSlice and the simulated CPUs of the multi-core simulation,
+// which run slices for different processes at the same time
+void executeSlice(int idx, int start, int slice) {
+    // Log process execution for the timeline table
+    eventLogAppend(&eventLog, EVENT_RUNNING, start, processes.pid[idx], 0);
+
+    bool completes = advanceSlice(idx, start, slice);
+
+    // Log completion status
+    if (completes) {
+        eventLogAppend(&eventLog, EVENT_COMPLETED, start + slice, processes.pid[idx], 0);
+    }
+}
+
+// The work of executeSlice without the timeline events, which the simulated
+// CPUs log themselves
+// Returns true if the slice completes processes[idx]
+bool advanceSlice(int idx, int start, int slice) {
+    // Set state to RUNNING
+    processes.state[idx] = RUNNING;
+
+    // Decrement Remaining Time by the slice
+    processes.remainingTime[idx] -= slice;
+
+    // Check if process has completed
+    bool completes = processes.remainingTime[idx] == 0;
+    if (completes) {
+        processes.finished[idx] = 1;
+    }
+    recordSlice(idx, start, slice, completes);
+    return completes;
+}
+
+// Record the Start Time of processes[idx] and, if the slice completes it,
+// its results
+// Remaining Time and finished are up to the caller: a lock-free worker gets
+// slices the scheduler has already accounted for
+void recordSlice(int idx, int start, int slice, bool completes) {
+    // Record Start Time for Response Time calculation
+    if (!processes.hasStarted[idx]) {
+        processes.startTime[idx] = start;
+        processes.responseTime[idx] = processes.startTime[idx] - processes.arrivalTime[idx];
+        processes.hasStarted[idx] = 1;
+    }
+
+    if (completes) {
+        processes.completionTime[idx] = start + slice;
+        processes.turnaroundTime[idx] = processes.completionTime[idx] - processes.arrivalTime[idx];
+        processes.waitingTime[idx] = processes.turnaroundTime[idx] - processes.burstTime[idx];
+        processes.state[idx] = COMPLETED;
+
+        // Fold the finished process into this thread's metric summaries
+        MetricStats *metrics = &threadShard->metrics;
+        onlineStatsAdd(&metrics->turnaround, processes.turnaroundTime[idx]);
+        onlineStatsAdd(&metrics->waiting, processes.waitingTime[idx]);
+        onlineStatsAdd(&metrics->response, processes.responseTime[idx]);
+    } else {
+        // Set back to READY after execution
+        processes.state[idx] = READY;
+    }
+}
+
+// Lock-free worker thread: takes dispatch records from its ring, records the
+// slice and publishes a completion record back to the scheduler
+void *lockFreeWorkerThread(void *arg) {
+    LockFreeWorker *worker = (LockFreeWorker *)arg;
+    SliceRecord record;
+    threadShard = &statsShards[worker - lockFreeWorkers];
+
+    // A worker logs the slices of many processes
+    eventLogRegisterThread(&eventLog, EVENT_RING_LARGE);
+    instrThreadStart(INSTR_ROLE_WORKER);
+
+    while (1) {
+        // Wait for the next dispatch
+        if (!ringPop(&worker->dispatch, &record)) {
+            ringWait(&worker->dispatch, false);
+            continue;
+        }
+
+        // Exit when the scheduler is done
+        if (record.idx < 0) break;
+
+        recordSlice(record.idx, record.start, record.slice, record.completes);
+
+        // Report back; the release store in ringPush makes every update made
+        // by recordSlice visible to the scheduler once it pops the record
+        while (!ringPush(&worker->completion, record)) ringWait(&worker->completion, true);
+    }
+
+    return NULL;
+}
+
+// Hand processes[idx] a slice through the lock-free rings without waiting for it
+// The scheduler advances the clock and the Remaining Time itself, which is
+// all it needs to pick the next process, and logs the slice on the worker's
+// behalf so the timeline stays in dispatch order; the worker records the
+// Start Time and results in the background
+// Each process always goes to the same worker, which keeps its data in one
+// cache and records its slices in order
+void dispatchLockFree(int idx, int slice) {
+    LockFreeWorker *worker = &lockFreeWorkers[idx % numWorkers];
+    int start = globalCurrentTime;
+    globalCurrentTime = start + slice;
+    processes.remainingTime[idx] -= slice;
+    bool completes = processes.remainingTime[idx] == 0;
+    if (completes) {
+        processes.finished[idx] = 1;
+    }
+
+    eventLogAppendAs(&eventLog, (uint64_t)worker->thread, EVENT_RUNNING, start, processes.pid[idx], 0);
+    if (completes) {
+        eventLogAppendAs(&eventLog, (uint64_t)worker->thread, EVENT_COMPLETED, start + slice, processes.pid[idx], 0);
+    }
+
+    // Take in whatever the worker has finished first: it can only fill the
+    // completion ring again by popping dispatches, which makes room here, so
+    // the two never sleep waiting for each other
+    SliceRecord record = {idx, start, slice, completes};
+    drainCompletions(worker);
+    while (!ringPush(&worker->dispatch, record)) {
+        ringWait(&worker->dispatch, true);
+        drainCompletions(worker);
+    }
+    worker->dispatched++;
+}
+
+// Pop every completion record the worker has published so far
+void drainCompletions(LockFreeWorker *worker) {
+    SliceRecord record;
+    while (ringPop(&worker->completion, &record)) worker->completed++;
+}
+
+// Wait until the worker has recorded every slice dispatched to it
+// Its updates to the Process table are then visible to the scheduler
+void waitForWorker(LockFreeWorker *worker) {
+    SliceRecord record;
+    while (worker->completed < worker->dispatched) {
+        if (ringPop(&worker->completion, &record)) {
+            worker->completed++;
+        } else {
+            ringWait(&worker->completion, false);
+        }
+    }
+}
+
+// Append a record to the ring (producer side)
+// Returns false if the ring is full
+bool ringPush(SpscRing *ring, SliceRecord record) {
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head == RING_CAPACITY) return false;
+
+    ring->slots[tail & (RING_CAPACITY - 1)] = record;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    ringWake(ring);
+    return true;
+}
+
+// Take the oldest record from the ring (consumer side)
+// Returns false if the ring is empty
+bool ringPop(SpscRing *ring, SliceRecord *record) {
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == tail) return false;
+
+    *record = ring->slots[head & (RING_CAPACITY - 1)];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    ringWake(ring);
+    return true;
+}
+
+void ringInit(SpscRing *ring) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->parked, false);
+    pthread_mutex_init(&ring->parkMutex, NULL);
+    pthread_cond_init(&ring->parkCond, NULL);
+}
+
+void ringDestroy(SpscRing *ring) {
+    pthread_mutex_destroy(&ring->parkMutex);
+    pthread_cond_destroy(&ring->parkCond);
+}
+
+// True if the ring has a record to pop, or with forRoom a free slot to push into
+static inline bool ringReady(SpscRing *ring, bool forRoom) {
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return forRoom ? tail - head < RING_CAPACITY : head != tail;
+}
+
+// Wait until the ring has a record to pop, or with forRoom a free slot
+// Spins briefly with a CPU pause hint, then yields so the thread on the other
+// end of the ring can run even when both share a core, then sleeps until the
+// other end pushes or pops (ringWake), so an idle thread uses no CPU
+void ringWait(SpscRing *ring, bool forRoom) {
+    for (int spins = 0; spins < RING_SPIN_PAUSES + RING_SPIN_YIELDS; spins++) {
+        if (ringReady(ring, forRoom)) return;
+        if (spins < RING_SPIN_PAUSES) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        } else {
+            sched_yield();
+        }
+    }
+
+    // Publish the flag before checking the ring one last time; ringWake
+    // makes its update before checking the flag, and the two fences
+    // guarantee at least one side sees the other's store
+    pthread_mutex_lock(&ring->parkMutex);
+    atomic_store_explicit(&ring->parked, true, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!ringReady(ring, forRoom)) {
+        pthread_cond_wait(&ring->parkCond, &ring->parkMutex);
+    }
+    atomic_store_explicit(&ring->parked, false, memory_order_relaxed);
+    pthread_mutex_unlock(&ring->parkMutex);
+}
+
+// Wake the thread sleeping in ringWait on the other end of the ring, if any
+// Called after every push and pop
+void ringWake(SpscRing *ring) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->parked, memory_order_relaxed)) {
+        pthread_mutex_lock(&ring->parkMutex);
+        pthread_cond_signal(&ring->parkCond);
+        pthread_mutex_unlock(&ring->parkMutex);
+    }
+}
+
+// Worker pool thread: runs whichever process the scheduler dispatches
+// Used instead of one thread per process when --pool or --workers is given
+void *workerThread(void *arg) {
+    threadShard = &statsShards[(intptr_t)arg];
+
+    // A worker logs the slices of many processes
+    eventLogRegisterThread(&eventLog, EVENT_RING_LARGE);
+    instrThreadStart(INSTR_ROLE_WORKER);
+
+    while (1) {
+        instrMutexLock(&schedulerMutex);
+
+        // Wait until a slice is dispatched or scheduler stops
+        // (another worker may have claimed the slice first)
+        while (globalCurrentProcess == -1 && schedulerRunning) {
+            instrCondWait(&schedulerCond, &schedulerMutex);
+            if (globalCurrentProcess == -1 && schedulerRunning) instrCount(INSTR_SPURIOUS_WAKEUPS);
+        }
+
+        // Exit if scheduler stopped
+        if (!schedulerRunning) {
+            instrMutexUnlock(&schedulerMutex);
+            break;
+        }
+
+        // Claim the task; globalCurrentProcess is reset before the mutex is
+        // released, so no other worker can pick it up as well
+        runSlice(globalCurrentProcess, globalSliceLength);
+
+        // Reset current process and hand control back to the scheduler
+        globalCurrentProcess = -1;
+        pthread_cond_signal(&sliceDoneCond);
+
+        instrMutexUnlock(&schedulerMutex);
+    }
+
+    return NULL;
+}
+
+// Run one simulation of processes[0..numProcesses-1] on numCpus simulated CPUs
+// (--cpus) to completion
+// The calling thread schedules: it admits arrivals, picks what every CPU runs
+// next and advances time. Within a step the CPUs run different processes, so
+// their slices are executed in parallel by numCoreThreads simulation threads,
+// each owning a contiguous range of CPUs; a barrier separates the steps, as
+// the next choices depend on every slice of the current one.
+// Returns false if the CPUs or a thread could not be created
+bool runMultiCoreSimulation(RunStats *stats) {
+    int n = numProcesses;
+    int i;
+
+    // One simulation thread per host core by default, never more than CPUs
+    numCoreThreads = numWorkers;
+    if (numCoreThreads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        numCoreThreads = cores > 0 ? (int)cores : 1;
+    }
+    if (numCoreThreads > numCpus) numCoreThreads = numCpus;
+
+    void *storage = NULL;
+    if (posix_memalign(&storage, CACHE_LINE, (size_t)numCpus * sizeof(SimCore)) != 0) {
+        fprintf(stderr, "Error allocating %d simulated CPUs\n", numCpus);
+        return false;
+    }
+    simCores = storage;
+    memset(simCores, 0, (size_t)numCpus * sizeof(SimCore));
+    for (i = 0; i < numCpus; i++) {
+        simCores[i].running = -1;
+        simCores[i].lastPid = -1;
+        // Per-core queues share readyPos: a process waits in at most one queue
+        readyQueueInit(&simCores[i].queue, processes.queueKey, processes.sequence, 0, NULL, readyPos);
+    }
+    lastCore = malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    if (lastCore == NULL || !statsShardsInit(numCoreThreads)) {
+        fprintf(stderr, "Error allocating memory for %d processes\n", n);
+        return false;
+    }
+    for (i = 0; i < n; i++) {
+        lastCore[i] = -1;
+    }
+
+    struct timespec runStart, runEnd;
+    PerfCounter cacheMissCounter;
+    perfCounterOpen(&cacheMissCounter, PERF_COUNT_HW_CACHE_MISSES);
+    long switchesBefore = contextSwitchCount();
+    clock_gettime(CLOCK_MONOTONIC, &runStart);
+    perfCounterStart(&cacheMissCounter);
+
+    // This thread runs the first range of CPUs itself
+    pthread_t *threads = malloc((size_t)numCoreThreads * sizeof(pthread_t));
+    if (threads == NULL) {
+        fprintf(stderr, "Error allocating simulation threads\n");
+        return false;
+    }
+    if (numCoreThreads > 1) {
+        pthread_barrier_init(&coreBarrier, NULL, (unsigned)numCoreThreads);
+    }
+    for (i = 1; i < numCoreThreads; i++) {
+        if (pthread_create(&threads[i], NULL, coreThread, (void *)(intptr_t)i) != 0) {
+            fprintf(stderr, "Error creating simulation thread %d\n", i + 1);
+            return false;
+        }
+    }
+    threadShard = &statsShards[0];
+    eventLogRegisterThread(&eventLog, EVENT_RING_LARGE);
+    instrThreadStart(INSTR_ROLE_SCHEDULER);
+
+    // Print table header
+    if (printTimeline) {
+        printf("%-6s %-12s %-12s %-15s %-10s\n",
+               "Time", "Process ID", "Status", "Remaining Time", "Thread ID");
+        printf("--------------------------------------------------------------------------------\n");
+    }
+
+    // Index of the next process to arrive (processes[] is sorted by Arrival Time)
+    int nextToArrive = 0;
+    int completed = 0;
+    int time = 0;
+    if (hasNextArrival(0) && nextArrivalTime(0) > 0) {
+        time = nextArrivalTime(0);
+    }
+
+    while (completed < n) {
+        // Admit every process that has arrived by now; with per-core queues
+        // each goes to the CPU with the least work
+        while (hasNextArrival(nextToArrive) && nextArrivalTime(nextToArrive) <= time) {
+            int row = nextToArrive++;
+            eventLogAppend(&eventLog, EVENT_READY, processes.arrivalTime[row],
+                           processes.pid[row], processes.remainingTime[row]);
+            processes.queueKey[row] = policy->onArrival(row);
+            if (queueMode == QUEUES_GLOBAL) {
+                readyQueuePush(&readyQueue, row);
+            } else {
+                coreQueuePush(coreLeastLoaded(), row);
+            }
+        }
+
+        // Decide what every CPU runs in this step
+        if (queueMode == QUEUES_GLOBAL) {
+            coreSelectGlobal();
+        } else {
+            runCorePhase(CORE_PHASE_SELECT);
+            // Stop looking once no CPU has anything left to steal
+            for (i = 0; i < numCpus; i++) {
+                if (simCores[i].running == -1 && !coreSteal(&simCores[i])) break;
+            }
+        }
+
+        // The step ends at the next arrival (which may preempt) or at the
+        // first completion; in tick mode after one time unit
+        int nextArrival = nextArrivalTime(nextToArrive);
+        int slice = eventDriven ? nextArrival - time : 1;
+        bool anyRunning = false;
+        for (i = 0; i < numCpus; i++) {
+            int idx = simCores[i].running;
+            if (idx == -1) continue;
+            anyRunning = true;
+            if (processes.remainingTime[idx] < slice) slice = processes.remainingTime[idx];
+            instrCount(INSTR_DECISIONS);
+        }
+
+        // Every CPU is idle until the next arrival
+        if (!anyRunning) {
+            for (i = 0; i < numCpus; i++) {
+                ganttAdd(&simCores[i].lane, 0, time, nextArrival);
+            }
+            eventLogAppend(&eventLog, EVENT_IDLE, time, 0, nextArrival);
+            time = nextArrival;
+            instrCount(INSTR_IDLE_JUMPS);
+            continue;
+        }
+
+        coreStepTime = time;
+        coreStepSlice = slice;
+        runCorePhase(CORE_PHASE_RUN);
+        coreLogStep();
+        time += slice;
+        globalCurrentTime = time;
+
+        // A finished process frees its CPU
+        for (i = 0; i < numCpus; i++) {
+            int idx = simCores[i].running;
+            if (idx != -1 && processes.finished[idx]) {
+                simCores[i].running = -1;
+                completed++;
+            }
+        }
+
+        // Optional delay to watch the simulation in real time
+        if (realtimeScale > 0) {
+            realtimeDelay(slice);
+        }
+    }
+    runCorePhase(CORE_PHASE_EXIT);
+
+    for (i = 1; i < numCoreThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    if (numCoreThreads > 1) {
+        pthread_barrier_destroy(&coreBarrier);
+    }
+    stats->cacheMisses = perfCounterStop(&cacheMissCounter);
+    perfCounterClose(&cacheMissCounter);
+    clock_gettime(CLOCK_MONOTONIC, &runEnd);
+    stats->seconds = elapsedSeconds(runStart, runEnd);
+    stats->contextSwitches = contextSwitchCount() - switchesBefore;
+    stats->decisions = 0;
+    for (i = 0; i < numCpus; i++) {
+        stats->decisions += simCores[i].slices;
+    }
+
+    statsShardsMerge(&metricStats);
+    free(lastCore);
+    lastCore = NULL;
+    return true;
+}
+
+// Simulation thread: runs its range of CPUs in every phase until the
+// scheduling thread announces the end
+void *coreThread(void *arg) {
+    int thread = (int)(intptr_t)arg;
+    threadShard = &statsShards[thread];
+    instrThreadStart(INSTR_ROLE_WORKER);
+
+    while (1) {
+        pthread_barrier_wait(&coreBarrier);
+        CorePhase phase = corePhase;
+        if (phase == CORE_PHASE_EXIT) break;
+        runCoreRange(thread, phase);
+        pthread_barrier_wait(&coreBarrier);
+    }
+
+    return NULL;
+}
+
+// Run a phase on every simulated CPU and wait until all have finished it
+// The barrier also publishes the scheduling thread's changes to the CPUs
+// and the CPUs' results back to it
+void runCorePhase(CorePhase phase) {
+    corePhase = phase;
+    if (numCoreThreads > 1) pthread_barrier_wait(&coreBarrier);
+    if (phase == CORE_PHASE_EXIT) return;
+    runCoreRange(0, phase);
+    if (numCoreThreads > 1) pthread_barrier_wait(&coreBarrier);
+}
+
+// Run a phase on the CPUs owned by one simulation thread
+void runCoreRange(int thread, CorePhase phase) {
+    int first = (int)((long)thread * numCpus / numCoreThreads);
+    int last = (int)((long)(thread + 1) * numCpus / numCoreThreads);
+
+    for (int c = first; c < last; c++) {
+        if (phase == CORE_PHASE_SELECT) {
+            coreSelectLocal(&simCores[c]);
+        } else {
+            coreRunSlice(&simCores[c]);
+        }
+    }
+}
+
+// Global ready queue: idle CPUs take the head of the queue, then the head
+// replaces the running process the policy ranks last, for as long as the
+// policy says it should preempt it. The CPUs end up running the numCpus
+// best processes; with one CPU this is exactly the single-CPU scheduler.
+void coreSelectGlobal(void) {
+    for (int c = 0; c < numCpus; c++) {
+        int candidate = readyQueuePeek(&readyQueue);
+        if (candidate == -1) return;
+        if (simCores[c].running == -1) {
+            readyQueueRemove(&readyQueue, candidate);
+            simCores[c].running = candidate;
+        }
+    }
+
+    int candidate;
+    while ((candidate = readyQueuePeek(&readyQueue)) != -1) {
+        // Running process every other running process would preempt
+        int victim = 0;
+        for (int c = 1; c < numCpus; c++) {
+            if (policy->shouldPreempt(simCores[c].running, simCores[victim].running, 0)) {
+                victim = c;
+            }
+        }
+        int running = simCores[victim].running;
+        if (!policy->shouldPreempt(running, candidate, 0)) return;
+
+        readyQueueRemove(&readyQueue, candidate);
+        processes.queueKey[running] = policy->onPreempt(running);
+        readyQueuePush(&readyQueue, running);
+        simCores[victim].running = candidate;
+        instrCount(INSTR_PREEMPTIONS);
+    }
+}
+
+// Per-core queue: the CPU's own single-CPU decision, made in parallel with
+// the other CPUs
+void coreSelectLocal(SimCore *core) {
+    int candidate = readyQueuePeek(&core->queue);
+    if (candidate == -1) return;
+
+    if (core->running != -1 && policy->shouldPreempt(core->running, candidate, 0)) {
+        processes.queueKey[core->running] = policy->onPreempt(core->running);
+        coreQueuePush(core, core->running);
+        core->running = -1;
+        instrCount(INSTR_PREEMPTIONS);
+    }
+    if (core->running == -1) {
+        core->running = readyQueuePeek(&core->queue);
+        readyQueueRemove(&core->queue, core->running);
+    }
+}
+
+// An idle CPU with an empty queue takes the best waiting process of the
+// CPU with the most waiting processes
+// Returns false if no CPU has a waiting process
+bool coreSteal(SimCore *thief) {
+    SimCore *victim = NULL;
+    for (int c = 0; c < numCpus; c++) {
+        if (simCores[c].queue.size > 0 && (victim == NULL || simCores[c].queue.size > victim->queue.size)) {
+            victim = &simCores[c];
+        }
+    }
+    if (victim == NULL) return false;
+
+    int idx = readyQueuePeek(&victim->queue);
+    readyQueueRemove(&victim->queue, idx);
+    thief->running = idx;
+    thief->steals++;
+    return true;
+}
+
+// CPU with the fewest running and waiting processes (the lowest-numbered on ties)
+SimCore *coreLeastLoaded(void) {
+    SimCore *best = &simCores[0];
+    int bestLoad = best->queue.size + (best->running != -1);
+    for (int c = 1; c < numCpus; c++) {
+        int load = simCores[c].queue.size + (simCores[c].running != -1);
+        if (load < bestLoad) {
+            best = &simCores[c];
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+// Add a process to a CPU's ready queue, growing its heap when full
+void coreQueuePush(SimCore *core, int idx) {
+    if (core->queue.size == core->queueCapacity) {
+        int capacity = core->queueCapacity > 0 ? core->queueCapacity * 2 : 16;
+        int *heap = realloc(core->queue.heap, (size_t)capacity * sizeof(int));
+        if (heap == NULL) {
+            fprintf(stderr, "Error allocating ready queue of %d processes\n", capacity);
+            exit(1);
+        }
+        core->queue.heap = heap;
+        core->queueCapacity = capacity;
+    }
+    readyQueuePush(&core->queue, idx);
+}
+
+// Run the step's slice on one CPU (or record it as idle)
+void coreRunSlice(SimCore *core) {
+    int idx = core->running;
+    int start = coreStepTime;
+    int end = coreStepTime + coreStepSlice;
+
+    if (idx == -1) {
+        ganttAdd(&core->lane, 0, start, end);
+        return;
+    }
+
+    int pid = processes.pid[idx];
+    int cpu = (int)(core - simCores);
+    if (core->lastPid != -1 && core->lastPid != pid) {
+        coreLogEvent(core, EVENT_PREEMPTION, start, core->lastPid, pid);
+    }
+    if (lastCore[idx] != -1 && lastCore[idx] != cpu) {
+        core->migrations++;
+    }
+    lastCore[idx] = cpu;
+    core->lastPid = pid;
+    core->slices++;
+    core->busyTime += coreStepSlice;
+
+    coreLogEvent(core, EVENT_RUNNING, start, pid, 0);
+    if (advanceSlice(idx, start, coreStepSlice)) {
+        coreLogEvent(core, EVENT_COMPLETED, end, pid, 0);
+    }
+    ganttAdd(&core->lane, pid, start, end);
+}
+
+// Keep a timeline event of the current step until coreLogStep logs it
+void coreLogEvent(SimCore *core, int type, int time, int pid, int arg) {
+    EventRecord *record = &core->events[core->eventCount++];
+    record->thread = (uint64_t)pthread_self();
+    record->type = type;
+    record->time = time;
+    record->pid = pid;
+    record->arg = arg;
+}
+
+// Log the timeline events of the step the CPUs just ran, in order of time
+// and then CPU, however their threads interleaved
+// Every event of a step is at its start or, for completions, at its end
+void coreLogStep(void) {
+    int end = coreStepTime + coreStepSlice;
+    for (int pass = 0; pass < 2; pass++) {
+        int time = pass == 0 ? coreStepTime : end;
+        for (int c = 0; c < numCpus; c++) {
+            for (int e = 0; e < simCores[c].eventCount; e++) {
+                EventRecord *record = &simCores[c].events[e];
+                if (record->time != time) continue;
+                eventLogAppendAs(&eventLog, record->thread, record->type, record->time,
+                                 record->pid, record->arg);
+            }
+        }
+    }
+    for (int c = 0; c < numCpus; c++) {
+        simCores[c].eventCount = 0;
+    }
+}
+
+// Release the simulated CPUs and their Gantt lanes and queues
+void freeSimCores(void) {
+    if (simCores == NULL) return;
+    for (int c = 0; c < numCpus; c++) {
+        ganttFree(&simCores[c].lane);
+        free(simCores[c].queue.heap);
+    }
+    free(simCores);
+    simCores = NULL;
+}
+
+// Get string representation of process state
+const char* getStateName(ProcessState state) {
+    switch(state) {
+        case READY: return "READY";
+        case RUNNING: return "RUNNING";
+        case COMPLETED: return "COMPLETED";
+        default: return "UNKNOWN";
+    }
+}
+
+// Format one timeline event as the row or message the simulator used to
+// print directly; runs on the event log's writer thread
+int formatTimelineEvent(const EventRecord *record, char *buf, size_t size) {
+    char pidStr[16];
+
+    switch (record->type) {
+        case EVENT_READY:
+            snprintf(pidStr, sizeof(pidStr), "P%d", record->pid);
+            return snprintf(buf, size, "%-6d %-12s %-12s %-15d %-10s\n",
+                            record->time, pidStr, "READY", record->arg, "-");
+        case EVENT_RUNNING:
+        case EVENT_COMPLETED:
+            snprintf(pidStr, sizeof(pidStr), "P%d", record->pid);
+            return snprintf(buf, size, "%-6d %-12s %-12s %-15s %-10lu\n",
+                            record->time, pidStr,
+                            getStateName(record->type == EVENT_RUNNING ? RUNNING : COMPLETED),
+                            "0", (unsigned long)record->thread);
+        case EVENT_IDLE:
+            return snprintf(buf, size, "\n>>> Time %d-%d: CPU IDLE <<<\n\n", record->time, record->arg);
+        case EVENT_PREEMPTION:
+            return snprintf(buf, size, "\n>>> Time %d: **PREEMPTION** - Switching from P%d to P%d <<<\n\n",
+                            record->time, record->pid, record->arg);
+        default:
+            return 0;
+    }
+}
+
+// Sort processes by arrival time
+// Stable: processes with the same Arrival Time keep their input order,
+// matching the order trace_convert writes sorted binary traces in
+// Runtime: O(n) (radix sort on an array of row indices, see arrival_sort.h);
+// every column is then permuted once into the sorted order
+void sortByArrival(int n) {
+    int i;
+    if (n <= 0) return;
+
+    int *order = malloc((size_t)n * sizeof(int));
+    if (order == NULL || !sortIndicesByArrival(processes.arrivalTime, sizeof(int), n, order)) {
+        fprintf(stderr, "Error allocating memory to sort %d processes\n", n);
+        exit(1);
+    }
+
+    // Input that is already in order (as most traces are) needs no moves
+    for (i = 0; i < n && order[i] == i; i++);
+    if (i == n) {
+        for (i = 0; i < n; i++) processes.sequence[i] = i;
+        free(order);
+        return;
+    }
+
+    // Gather each column through the sorted order
+    size_t widest = 0;
+#define COLUMN_WIDTH(field) if (sizeof(*processes.field) > widest) widest = sizeof(*processes.field);
+    PROCESS_COLUMNS(COLUMN_WIDTH)
+#undef COLUMN_WIDTH
+    char *scratch = malloc((size_t)n * widest);
+    if (scratch == NULL) {
+        fprintf(stderr, "Error allocating memory to sort %d processes\n", n);
+        exit(1);
+    }
+#define COLUMN_PERMUTE(field)                                                  \
+    for (i = 0; i < n; i++) {                                                  \
+        memcpy(scratch + (size_t)i * sizeof(*processes.field),                 \
+               &processes.field[order[i]], sizeof(*processes.field));          \
+    }                                                                          \
+    memcpy(processes.field, scratch, (size_t)n * sizeof(*processes.field));
+    PROCESS_COLUMNS(COLUMN_PERMUTE)
+#undef COLUMN_PERMUTE
+    for (i = 0; i < n; i++) processes.sequence[i] = i;
+
+    free(scratch);
+    free(order);
+}
+
+// Ready-queue keys used by the policies
+// Lower keys run first; equal keys fall back to arrival order (sequence)
+static long keyRemainingTime(int idx) { return processes.remainingTime[idx]; }
+static long keyBurstTime(int idx) { return processes.burstTime[idx]; }
+static long keyArrivalTime(int idx) { return processes.arrivalTime[idx]; }
+static long keyPriority(int idx) { return processes.priority[idx]; }
+static long keyNextInLine(int idx) { (void)idx; return roundRobinSequence++; }
+
+// SRTF: a process with a shorter Remaining Time (or equal, arriving earlier)
+// takes over, as in findShortestJob
+static bool preemptShorterRemaining(int running, int candidate, int used) {
+    (void)used;
+    int r = processes.remainingTime[running];
+    int c = processes.remainingTime[candidate];
+    return c < r || (c == r && processes.sequence[candidate] < processes.sequence[running]);
+}
+
+// Preemptive priority: a more urgent process (lower number) takes over
+static bool preemptHigherPriority(int running, int candidate, int used) {
+    (void)used;
+    int r = processes.priority[running];
+    int c = processes.priority[candidate];
+    return c < r || (c == r && processes.sequence[candidate] < processes.sequence[running]);
+}
+
+// Non-preemptive policies keep the running process until it completes
+static bool preemptNever(int running, int candidate, int used) {
+    (void)running;
+    (void)candidate;
+    (void)used;
+    return false;
+}
+
+// Round Robin: the running process yields once its quantum is used up
+static bool preemptQuantumExpired(int running, int candidate, int used) {
+    (void)running;
+    (void)candidate;
+    return used >= timeQuantum;
+}
+
+// Scheduler thread of each policy
+DEFINE_SCHEDULER_LOOP(schedulerThreadSrtf, keyRemainingTime, keyRemainingTime, preemptShorterRemaining, false)
+DEFINE_SCHEDULER_LOOP(schedulerThreadSjf, keyBurstTime, keyBurstTime, preemptNever, false)
+DEFINE_SCHEDULER_LOOP(schedulerThreadFcfs, keyArrivalTime, keyArrivalTime, preemptNever, false)
+DEFINE_SCHEDULER_LOOP(schedulerThreadRoundRobin, keyNextInLine, keyNextInLine, preemptQuantumExpired, true)
+DEFINE_SCHEDULER_LOOP(schedulerThreadPriority, keyPriority, keyPriority, preemptHigherPriority, false)
+
+// Every policy selectable with --policy; the first one is the default
+const SchedulingPolicy schedulingPolicies[] = {
+    {"srtf", "SRTF", "PREEMPTIVE",
+     "Note: SRTF allows preemption - processes can be interrupted\n"
+     "      when a shorter job arrives.\n",
+     true, false, keyRemainingTime, keyRemainingTime, preemptShorterRemaining, schedulerThreadSrtf},
+    {"sjf", "SJF", "NON-PREEMPTIVE",
+     "Note: SJF runs the job with the shortest Burst Time to completion -\n"
+     "      arrivals never interrupt the running process.\n",
+     false, false, keyBurstTime, keyBurstTime, preemptNever, schedulerThreadSjf},
+    {"fcfs", "FCFS", "NON-PREEMPTIVE",
+     "Note: FCFS runs processes to completion in order of arrival.\n",
+     false, false, keyArrivalTime, keyArrivalTime, preemptNever, schedulerThreadFcfs},
+    {"rr", "Round Robin", "TIME-SLICED",
+     "Note: Round Robin runs each process for up to %d time units,\n"
+     "      then moves it to the back of the ready queue.\n",
+     false, true, keyNextInLine, keyNextInLine, preemptQuantumExpired, schedulerThreadRoundRobin},
+    {"priority", "Priority", "PREEMPTIVE",
+     "Note: the lowest priority number runs first, and a more urgent\n"
+     "      arrival interrupts the running process.\n",
+     true, false, keyPriority, keyPriority, preemptHigherPriority, schedulerThreadPriority},
+};
+
+// Look up a policy by its --policy name, NULL if unknown
+const SchedulingPolicy *findPolicy(const char *name) {
+    for (size_t i = 0; i < sizeof(schedulingPolicies) / sizeof(schedulingPolicies[0]); i++) {
+        if (strcmp(schedulingPolicies[i].name, name) == 0) {
+            return &schedulingPolicies[i];
+        }
+    }
+    return NULL;
 }
 
 // Print scheduling results
-void printResults(Process proc[], int n) {
-    double totalTurnaround = 0, totalWaiting = 0, totalResponse = 0;
+// The averages and distribution come from the summaries collected as the
+// processes completed; the table is only read for the per-process lines
+void printResults(int n) {
     int i;
 
     printf("\n======================================\n");
@@ -512,36 +2426,163 @@ void printResults(Process proc[], int n) {
     printf("======================================\n\n");
 
     // Print individual process metrics
-    for (i = 0; i < n; i++) {
-        printf("Process P%d: Turnaround = %d, Waiting = %d, Response = %d\n",
-               proc[i].pid,
-               proc[i].turnaroundTime,
-               proc[i].waitingTime,
-               proc[i].responseTime);
-        
-        totalTurnaround += proc[i].turnaroundTime;
-        totalWaiting += proc[i].waitingTime;
-        totalResponse += proc[i].responseTime;
+    if (printProcessResults) {
+        for (i = 0; i < n; i++) {
+            printf("Process P%d: Turnaround = %d, Waiting = %d, Response = %d\n",
+                   processes.pid[i],
+                   processes.turnaroundTime[i],
+                   processes.waitingTime[i],
+                   processes.responseTime[i]);
+        }
     }
 
     // Print averages
-    printf("\nAverage Turnaround Time = %.2f\n", totalTurnaround / n);
-    printf("Average Waiting Time = %.2f\n", totalWaiting / n);
-    printf("Average Response Time = %.2f\n", totalResponse / n);
+    printf("\nAverage Turnaround Time = %.2f\n", onlineStatsMean(&metricStats.turnaround));
+    printf("Average Waiting Time = %.2f\n", onlineStatsMean(&metricStats.waiting));
+    printf("Average Response Time = %.2f\n", onlineStatsMean(&metricStats.response));
+
+    printMetricDistribution(&metricStats);
+}
+
+// Print mean, spread and tail percentiles of each metric
+// Percentiles are read from the summaries' histograms (within 1%)
+void printMetricDistribution(const MetricStats *stats) {
+    const char *names[3] = {"Turnaround", "Waiting", "Response"};
+    const OnlineStats *metrics[3] = {&stats->turnaround, &stats->waiting, &stats->response};
+
+    printf("\n%-11s %10s %10s %8s %8s %8s %8s %8s\n",
+           "Metric", "Mean", "Std dev", "Min", "P50", "P95", "P99", "Max");
+    for (int m = 0; m < 3; m++) {
+        const OnlineStats *metric = metrics[m];
+        printf("%-11s %10.2f %10.2f %8d %8d %8d %8d %8d\n",
+               names[m],
+               onlineStatsMean(metric),
+               onlineStatsStddev(metric),
+               metric->count > 0 ? metric->min : 0,
+               onlineStatsPercentile(metric, 50),
+               onlineStatsPercentile(metric, 95),
+               onlineStatsPercentile(metric, 99),
+               metric->max);
+    }
+}
+
+// Allocate (or reuse) and clear one metric shard per thread for a new run
+// Returns false if the shards cannot be allocated
+bool statsShardsInit(int shards) {
+    if (shards < 1) shards = 1;
+    if (shards != numStatsShards) {
+        void *storage = NULL;
+        if (posix_memalign(&storage, CACHE_LINE, (size_t)shards * sizeof(StatsShard)) != 0) {
+            return false;
+        }
+        free(statsShards);
+        statsShards = storage;
+        numStatsShards = shards;
+    }
+    for (int i = 0; i < numStatsShards; i++) {
+        onlineStatsInit(&statsShards[i].metrics.turnaround);
+        onlineStatsInit(&statsShards[i].metrics.waiting);
+        onlineStatsInit(&statsShards[i].metrics.response);
+    }
+    return true;
+}
+
+// Combine the shards of the finished run into one summary
+// Called after the threads writing them have been joined
+void statsShardsMerge(MetricStats *into) {
+    onlineStatsInit(&into->turnaround);
+    onlineStatsInit(&into->waiting);
+    onlineStatsInit(&into->response);
+    for (int i = 0; i < numStatsShards; i++) {
+        onlineStatsMerge(&into->turnaround, &statsShards[i].metrics.turnaround);
+        onlineStatsMerge(&into->waiting, &statsShards[i].metrics.waiting);
+        onlineStatsMerge(&into->response, &statsShards[i].metrics.response);
+    }
+}
+
+// Print the Gantt chart of the run, one lane per simulated CPU
+// Short charts (or --gantt-width=full) are drawn slice by slice at 4
+// characters per time unit; longer ones are downsampled to the terminal
+// width (or --gantt-width) so they stay readable and fast to print
+void printGantt(GanttLog *const lanes[], int count) {
+    int start = __INT_MAX__, end = 0;
+    for (int l = 0; l < count; l++) {
+        if (lanes[l]->size == 0) continue;
+        if (ganttFirstStart(lanes[l]) < start) start = ganttFirstStart(lanes[l]);
+        if (ganttLastEnd(lanes[l]) > end) end = ganttLastEnd(lanes[l]);
+    }
+
+    if (ganttWidth < 0 || (ganttWidth == 0 && end - start <= GANTT_FULL_MAX_UNITS)) {
+        if (numCpus > 0) {
+            printGanttLanes();
+        } else {
+            printGanttChart(lanes[0]);
+        }
+        return;
+    }
+
+    printf("\n======================================\n");
+    if (numCpus > 0) {
+        printf("  Gantt Chart (%d CPUs)\n", numCpus);
+    } else {
+        printf("  Gantt Chart\n");
+    }
+    printf("======================================\n\n");
+
+    // Leave room for the lane label and borders
+    int width = ganttWidth > 0 ? ganttWidth : terminalWidth() - (count > 1 ? 10 : 2);
+    if (width < 10) width = 10;
+    if (!ganttPrintCompact(stdout, lanes, count, width, ganttUtilisation)) {
+        fprintf(stderr, "Error allocating memory for the Gantt chart\n");
+    }
+}
+
+// Columns of the terminal stdout writes to, from the terminal itself or
+// $COLUMNS, GANTT_DEFAULT_WIDTH if neither is known
+int terminalWidth(void) {
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+    const char *columns = getenv("COLUMNS");
+    if (columns != NULL && atoi(columns) > 0) {
+        return atoi(columns);
+    }
+    return GANTT_DEFAULT_WIDTH;
 }
 
 // Print Gantt chart
-void printGanttChart(GanttEntry gantt[], int size) {
-    int i;
-    
+void printGanttChart(GanttLog *log) {
     printf("\n======================================\n");
     printf("  Gantt Chart\n");
     printf("======================================\n\n");
 
+    printGanttBars(log);
+}
+
+// Print one Gantt chart lane per simulated CPU
+void printGanttLanes(void) {
+    printf("\n======================================\n");
+    printf("  Gantt Chart (%d CPUs)\n", numCpus);
+    printf("======================================\n");
+
+    for (int c = 0; c < numCpus; c++) {
+        printf("\nCPU %d\n", c);
+        printGanttBars(&simCores[c].lane);
+    }
+}
+
+// Print the bars and time markers of one Gantt log
+// Each row decodes the log again with a cursor instead of expanding it
+void printGanttBars(GanttLog *log) {
+    GanttCursor cursor;
+    GanttEntry entry;
+
     // Print the top border of the bar Gantt chart
     printf(" ");
-    for (i = 0; i < size; i++) {
-        int duration = gantt[i].endTime - gantt[i].startTime;
+    ganttCursorInit(&cursor, log);
+    while (ganttCursorNext(&cursor, &entry)) {
+        int duration = entry.endTime - entry.startTime;
         for (int j = 0; j < duration * 4; j++) {
             printf("-");
         }
@@ -551,17 +2592,18 @@ void printGanttChart(GanttEntry gantt[], int size) {
     // Print the process IDs in its respective time slots 
     // or print IDLE for the time slots where there are no processes executing
     printf("|");
-    for (i = 0; i < size; i++) {
-        int duration = gantt[i].endTime - gantt[i].startTime;
+    ganttCursorInit(&cursor, log);
+    while (ganttCursorNext(&cursor, &entry)) {
+        int duration = entry.endTime - entry.startTime;
         int padding = duration * 4 - 3;
         int leftPad = padding / 2;
         int rightPad = padding - leftPad;
         
         for (int j = 0; j < leftPad; j++) printf(" ");
-        if (gantt[i].pid == 0) {
+        if (entry.pid == 0) {
             printf("IDLE");
         } else {
-            printf("P%d", gantt[i].pid);
+            printf("P%d", entry.pid);
         }
         for (int j = 0; j < rightPad; j++) printf(" ");
         printf("|");
@@ -570,8 +2612,9 @@ void printGanttChart(GanttEntry gantt[], int size) {
 
     // Print the bottom border of the bar Gantt chart
     printf(" ");
-    for (i = 0; i < size; i++) {
-        int duration = gantt[i].endTime - gantt[i].startTime;
+    ganttCursorInit(&cursor, log);
+    while (ganttCursorNext(&cursor, &entry)) {
+        int duration = entry.endTime - entry.startTime;
         for (int j = 0; j < duration * 4; j++) {
             printf("-");
         }
@@ -579,13 +2622,91 @@ void printGanttChart(GanttEntry gantt[], int size) {
     printf("\n");
 
     // Print the time markers below the Gantt chart
-    printf("%d", gantt[0].startTime);
-    for (i = 0; i < size; i++) {
-        int duration = gantt[i].endTime - gantt[i].startTime;
-        int numDigits = snprintf(NULL, 0, "%d", gantt[i].endTime);
+    if (log->size > 0) {
+        printf("%d", ganttFirstStart(log));
+    }
+    ganttCursorInit(&cursor, log);
+    while (ganttCursorNext(&cursor, &entry)) {
+        int duration = entry.endTime - entry.startTime;
+        int numDigits = snprintf(NULL, 0, "%d", entry.endTime);
         int spaces = duration * 4 - numDigits;
         for (int j = 0; j < spaces; j++) printf(" ");
-        printf("%d", gantt[i].endTime);
+        printf("%d", entry.endTime);
     }
     printf("\n");
-}
\ No newline at end of file
+}
+
+// Reserve a single block of capacity bytes for the arena
+// Returns false if the allocation fails
+bool arenaInit(Arena *arena, size_t capacity) {
+    arena->base = malloc(capacity);
+    arena->used = 0;
+    arena->capacity = arena->base != NULL ? capacity : 0;
+    return arena->base != NULL;
+}
+
+// Hand out size bytes from the arena, aligned to ARENA_ALIGNMENT
+// Returns NULL if the arena is exhausted
+void *arenaAlloc(Arena *arena, size_t size) {
+    size_t offset = (arena->used + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (offset > arena->capacity || size > arena->capacity - offset) {
+        return NULL;
+    }
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+
+// Release everything allocated from the arena at once
+void arenaFree(Arena *arena) {
+    free(arena->base);
+    arena->base = NULL;
+    arena->used = 0;
+    arena->capacity = 0;
+}
+
+// Print how busy each simulated CPU was and how processes moved between them
+void printCoreSummary(void) {
+    long migrations = 0, steals = 0;
+    int first = ganttFirstStart(&simCores[0].lane);
+    int span = globalCurrentTime - first;
+
+    printf("\n======================================\n");
+    printf("  CPUs\n");
+    printf("======================================\n\n");
+
+    printf("Ready queues         = %s\n",
+           queueMode == QUEUES_GLOBAL ? "global" : "per CPU, with work stealing");
+    printf("Simulation threads   = %d\n\n", numCoreThreads);
+    printf("%-6s %10s %12s %10s %12s %8s\n", "CPU", "Busy", "Utilization", "Slices", "Migrations", "Steals");
+    for (int c = 0; c < numCpus; c++) {
+        SimCore *core = &simCores[c];
+        printf("%-6d %10ld %11.1f%% %10ld %12ld %8ld\n",
+               c, core->busyTime, span > 0 ? 100.0 * core->busyTime / span : 0.0,
+               core->slices, core->migrations, core->steals);
+        migrations += core->migrations;
+        steals += core->steals;
+    }
+    printf("\nMigrations           = %ld\n", migrations);
+    printf("Steals               = %ld\n", steals);
+}
+
+// Print how much memory the process table and Gantt log used
+// The Gantt log is the sum of every lane (one per simulated CPU)
+void printMemoryUsage(Arena *arena, GanttLog *const lanes[], int count) {
+    size_t allocated = 0, encoded = 0;
+    long slices = 0;
+    for (int l = 0; l < count; l++) {
+        allocated += ganttBytes(lanes[l]);
+        encoded += lanes[l]->pid.size + lanes[l]->gap.size + lanes[l]->duration.size;
+        slices += lanes[l]->size;
+    }
+
+    printf("\n======================================\n");
+    printf("  Memory Usage\n");
+    printf("======================================\n\n");
+
+    printf("Process arena        = %zu bytes (%zu used)\n", arena->capacity, arena->used);
+    printf("Gantt log            = %zu bytes (%ld slices, %zu bytes of varints)\n",
+           allocated, slices, encoded);
+    printf("Total                = %zu bytes\n", arena->capacity + allocated);
+}
@@ -1,4 +1,7 @@
 #include<stdio.h>
+#include "arrival_sort.h"
+
+int order[15],sa[15],sb[15],sp[15];
 
 int pointer,pre,a[15],b[15],r[15],count=0,n,small,i,j,m,s=0,k=0,p[10], t[15]={0},w[15]={0},x,y,bs,temp,d=0;
 
@@ -28,31 +31,33 @@ r[i]=b[i];
 
 }
 
-for(x=0;x<n;x++)
+// sort by arrival time (stable radix sort on indices, then gather each array once)
 
-for( y=0;y<n-1;y++)
+if(!sortIndicesByArrival(a,sizeof(int),n,order))
 
-if(a[y]>a[y+1])
+return 1;
+
+for(x=0;x<n;x++)
 
 {
 
-temp = a[y+1];
+sa[x]=a[order[x]];
 
-a[y+1] = a[y];
+sb[x]=b[order[x]];
 
-a[y] = temp;
+sp[x]=p[order[x]];
 
-temp=b[y+1];
+}
 
-b[y+1] = b[y];
+for(x=0;x<n;x++)
 
-b[y] = temp;
+{
 
-temp = p[y+1];
+a[x]=sa[x];
 
-p[y+1] = p[y];
+b[x]=r[x]=sb[x];
 
-p[y] = temp;
+p[x]=sp[x];
 
 }
 
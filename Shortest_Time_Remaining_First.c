@@ -8,10 +8,14 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include "arrival_sort.h"
 
 //  Define constants
 #define MAX_PROC 10
 #define MAX_TIMELINE 1000
+#define REALTIME_MAX_DELAY 3600.0  // Longest --realtime pause for one step, in seconds
 
 // Enum for process states
 typedef enum {
@@ -66,9 +70,11 @@ int globalCurrentProcess = -1;                                  // Currently exe
 bool schedulerRunning = true;                                   // Scheduler running flag
 pthread_mutex_t schedulerMutex = PTHREAD_MUTEX_INITIALIZER;     // Mutex for synchronizing access
 pthread_cond_t schedulerCond = PTHREAD_COND_INITIALIZER;        // Condition variable for process scheduling
+pthread_cond_t sliceDoneCond = PTHREAD_COND_INITIALIZER;        // Signalled when the dispatched tick has run
 GanttEntry gantt[MAX_TIMELINE];                                 // Gantt chart entries
 int ganttSize = 0;                                              // Number of entries in Gantt chart
 int numProcesses = 0;                                           // Total number of processes
+double realtimeScale = 0;                                       // Pacing multiplier, 0 = run at full speed
 
 // Function prototypes
 void sortByArrival(Process proc[], int n);
@@ -80,13 +86,32 @@ void printGanttChart(GanttEntry gantt[], int size);
 void updateProcessStates(Process proc[], int n, int currentTime, int runningIdx);
 void printProcessTable(Process proc[], int n, int currentTime);
 const char* getStateName(ProcessState state);
+double elapsedSeconds(struct timespec start, struct timespec end);
+void realtimeDelay(int units);
+void printSimulationSpeed(int ticks, double seconds);
 
-int main() {
+int main(int argc, char *argv[]) {
     // Variable declarations
     // n if for number of processes 
     // i for loop iteration
     int n, i;
 
+    // --realtime=SCALE paces the simulation at 100ms per time unit / SCALE
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--realtime=", 11) == 0) {
+            char *end;
+            realtimeScale = strtod(argv[i] + 11, &end);
+            if (*end != '\0' || realtimeScale <= 0) {
+                fprintf(stderr, "Invalid real-time scale: %s\n", argv[i] + 11);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--realtime=SCALE]\n", argv[0]);
+            return 1;
+        }
+    }
+
     printf("======================================\n");
     printf("  SRTF Process Scheduling Simulator\n");
     printf("  (Multithreaded Implementation)\n");
@@ -189,6 +214,10 @@ int main() {
     // Create pthread_t variable for scheduler
     pthread_t scheduler;
 
+    // Wall-clock timing for the simulation speed report
+    struct timespec runStart, runEnd;
+    clock_gettime(CLOCK_MONOTONIC, &runStart);
+
     // Creates and runs the scheduler thread
     // Checks if there is an error when creating the scheduler thread
     if (pthread_create(&scheduler, NULL, schedulerThread, NULL) != 0) {
@@ -215,6 +244,7 @@ int main() {
     for (i = 0; i < n; i++) {
         pthread_join(processes[i].thread, NULL);
     }
+    clock_gettime(CLOCK_MONOTONIC, &runEnd);
 
     // Display results
     printResults(processes, n);
@@ -222,9 +252,13 @@ int main() {
     // Display Gantt chart
     printGanttChart(gantt, ganttSize);
 
+    // Display how fast the simulation ran
+    printSimulationSpeed(globalCurrentTime, elapsedSeconds(runStart, runEnd));
+
     // Cleanup
     pthread_mutex_destroy(&schedulerMutex);
     pthread_cond_destroy(&schedulerCond);
+    pthread_cond_destroy(&sliceDoneCond);
 
     return 0;
 }
@@ -341,11 +375,19 @@ void *schedulerThread(void *arg) {
 
         // Wake up the selected process
         pthread_cond_broadcast(&schedulerCond);
+
+        // Wait until the process has run its time unit
+        // pthread_cond_wait releases the mutex so the process thread can proceed
+        while (globalCurrentProcess != -1) {
+            pthread_cond_wait(&sliceDoneCond, &schedulerMutex);
+        }
         pthread_mutex_unlock(&schedulerMutex);
 
-        // Small delay to simulate time slice execution
-        // 100ms delay
-        usleep(100000); 
+        // Optional delay to watch the simulation in real time
+        // Scale 1 gives the original 100ms per time unit, larger scales run faster
+        if (realtimeScale > 0) {
+            realtimeDelay(1);
+        }
     }
 
     return NULL;
@@ -354,6 +396,8 @@ void *schedulerThread(void *arg) {
 // Process thread function to represent the individual process execution
 void *processThread(void *arg) {
     Process *proc = (Process *)arg;
+    // Position of this process in processes[] (differs from pid - 1 once sorted)
+    int idx = (int)(proc - processes);
 
     // While true loop that only breaks if either:
     // scheduler stops running 
@@ -362,7 +406,7 @@ void *processThread(void *arg) {
         pthread_mutex_lock(&schedulerMutex);
 
         // Wait until this process is scheduled or scheduler stops
-        while (globalCurrentProcess != (proc->pid - 1) && schedulerRunning) {
+        while (globalCurrentProcess != idx && schedulerRunning) {
             pthread_cond_wait(&schedulerCond, &schedulerMutex);
         }
 
@@ -431,8 +475,9 @@ void *processThread(void *arg) {
             proc->state = READY;
         }
 
-        // Reset current process
+        // Reset current process and hand control back to the scheduler
         globalCurrentProcess = -1;
+        pthread_cond_signal(&sliceDoneCond);
 
         pthread_mutex_unlock(&schedulerMutex);
     }
@@ -459,28 +504,24 @@ const char* getStateName(ProcessState state) {
     }
 }
 
-// Sort processes by arrival time (improved bubble sort)
-// Added swapped flag for optimisation
-// Improved bubble sort runtime:
-// Best case: O(n)
-// Worst case: O(n^2)
-// Source: Algorithms, Data Structures and Efficiency module
+// Sort processes by arrival time
+// Stable: processes with the same Arrival Time keep their input order
+// Runtime: O(n) (radix sort on an array of row indices, see arrival_sort.h);
+// each record is then moved once into the sorted order
 void sortByArrival(Process proc[], int n) {
-    int i, j;
-    bool swapped = true;
-
-    for (i = 0; i < n - 1 && swapped; i++) {
-        swapped = false;
-
-        for (j = i + 1; j < n; j++) {
-            if (proc[i].arrivalTime > proc[j].arrivalTime) {
-                Process temp = proc[i];
-                proc[i] = proc[j];
-                proc[j] = temp;
-                swapped = true;
-            }
-        }
+    int *order = malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    Process *sorted = malloc((size_t)(n > 0 ? n : 1) * sizeof(Process));
+    if (order == NULL || sorted == NULL ||
+        !sortIndicesByArrival(&proc[0].arrivalTime, sizeof(Process), n, order)) {
+        fprintf(stderr, "Error allocating memory to sort %d processes\n", n);
+        exit(1);
     }
+
+    for (int i = 0; i < n; i++) sorted[i] = proc[order[i]];
+    memcpy(proc, sorted, (size_t)n * sizeof(Process));
+
+    free(sorted);
+    free(order);
 }
 
 // Find process with shortest Remaining Time that has arrived
@@ -530,6 +571,41 @@ void printResults(Process proc[], int n) {
     printf("Average Response Time = %.2f\n", totalResponse / n);
 }
 
+// Sleep for the given number of simulated time units at the --realtime pace
+// (100ms per unit / realtimeScale)
+// usleep is limited to 1,000,000 us and its count overflows for long slices
+// or small scales, so the delay is capped at REALTIME_MAX_DELAY seconds and
+// slept with nanosleep, resuming after signals
+void realtimeDelay(int units) {
+    double seconds = 0.1 * units / realtimeScale;
+    if (!(seconds < REALTIME_MAX_DELAY)) seconds = REALTIME_MAX_DELAY;
+
+    struct timespec delay, left;
+    delay.tv_sec = (time_t)seconds;
+    delay.tv_nsec = (long)((seconds - (double)delay.tv_sec) * 1e9);
+    while (nanosleep(&delay, &left) != 0 && errno == EINTR) {
+        delay = left;
+    }
+}
+
+// Seconds between two CLOCK_MONOTONIC readings
+double elapsedSeconds(struct timespec start, struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Print the achieved simulation speed
+void printSimulationSpeed(int ticks, double seconds) {
+    printf("\n======================================\n");
+    printf("  Simulation Speed\n");
+    printf("======================================\n\n");
+
+    printf("Simulated time units = %d\n", ticks);
+    printf("Wall-clock time      = %.6f s\n", seconds);
+    if (seconds > 0) {
+        printf("Ticks per second     = %.2f\n", ticks / seconds);
+    }
+}
+
 // Print Gantt chart
 void printGanttChart(GanttEntry gantt[], int size) {
     int i;
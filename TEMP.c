@@ -8,10 +8,15 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include "trace_reader.h"
+#include "arrival_sort.h"
 
 //  Define constants
 #define MAX_PROC 10
 #define MAX_TIMELINE 1000
+#define REALTIME_MAX_DELAY 3600.0  // Longest --realtime pause for one step, in seconds
 
 // Structure representing each process
 typedef struct {
@@ -51,16 +56,19 @@ typedef struct {
 } SharedData;
 
 // Global variables (shared data among threads)
-Process processes[MAX_PROC];                                    // Sets a array with a maximum of 10 processes
+Process *processes = NULL;                                      // Process table (up to MAX_PROC when prompting)
 int globalCurrentTime = 0;                                      // Global time tracker
 int globalCompleted = 0;                                        // Number of completed processes
 int globalCurrentProcess = -1;                                  // Currently executing process index
 bool schedulerRunning = true;                                   // Scheduler running flag
 pthread_mutex_t schedulerMutex = PTHREAD_MUTEX_INITIALIZER;     // Mutex for synchronizing access
 pthread_cond_t schedulerCond = PTHREAD_COND_INITIALIZER;        // Condition variable for process scheduling
+pthread_cond_t sliceDoneCond = PTHREAD_COND_INITIALIZER;        // Signalled when the dispatched tick has run
 GanttEntry gantt[MAX_TIMELINE];                                 // Gantt chart entries
 int ganttSize = 0;                                              // Number of entries in Gantt chart
 int numProcesses = 0;                                           // Total number of processes
+const char *traceFile = NULL;                                   // Trace file to load instead of prompting
+double realtimeScale = 0;                                       // Pacing multiplier, 0 = run at full speed
 
 // Function prototypes
 void sortByArrival(Process proc[], int n);
@@ -69,18 +77,120 @@ void *processThread(void *arg);
 void *schedulerThread(void *arg);
 void printResults(Process proc[], int n);
 void printGanttChart(GanttEntry gantt[], int size);
+int readProcessesInteractively(void);
+int loadProcessesFromTrace(const char *path);
+double elapsedSeconds(struct timespec start, struct timespec end);
+void realtimeDelay(int units);
+void printSimulationSpeed(int ticks, double seconds);
 
-int main() {
+int main(int argc, char *argv[]) {
     // Variable declarations
     // n if for number of processes 
     // i for loop iteration
     int n, i;
 
+    // --trace=FILE loads the processes from a trace file instead of prompting
+    // --realtime=SCALE paces the simulation at 100ms per time unit / SCALE
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--trace=", 8) == 0) {
+            traceFile = argv[i] + 8;
+        } else if (strncmp(argv[i], "--realtime=", 11) == 0) {
+            char *end;
+            realtimeScale = strtod(argv[i] + 11, &end);
+            if (*end != '\0' || realtimeScale <= 0) {
+                fprintf(stderr, "Invalid real-time scale: %s\n", argv[i] + 11);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--trace=FILE] [--realtime=SCALE]\n", argv[0]);
+            return 1;
+        }
+    }
+
     printf("======================================\n");
     printf("  SRTF Process Scheduling Simulator\n");
     printf("  (Multithreaded Implementation)\n");
     printf("======================================\n\n");
     
+    // Read the workload from a trace file, or prompt for it
+    n = traceFile != NULL ? loadProcessesFromTrace(traceFile) : readProcessesInteractively();
+    if (n < 0) {
+        return 1;
+    }
+
+    // Set global number of processes
+    numProcesses = n;
+
+    // Sort processes by arrival time
+    sortByArrival(processes, n);
+
+    printf("\n======================================\n");
+    printf("  Execution Timeline (PREEMPTIVE)\n");
+    printf("======================================\n");
+    printf("Note: SRTF allows preemption - processes can be interrupted\n");
+    printf("      when a shorter job arrives.\n");
+    printf("Multithreading: Each process runs in its own thread,\n");
+    printf("                coordinated by the scheduler thread.\n\n");
+
+    // Create pthread_t variable for scheduler
+    pthread_t scheduler;
+
+    // Wall-clock timing for the simulation speed report
+    struct timespec runStart, runEnd;
+    clock_gettime(CLOCK_MONOTONIC, &runStart);
+
+    // Creates and runs the scheduler thread
+    // Checks if there is an error when creating the scheduler thread
+    if (pthread_create(&scheduler, NULL, schedulerThread, NULL) != 0) {
+        fprintf(stderr, "Error creating scheduler thread\n");
+        return 1;
+    }
+
+    // Create process threads and runs the processes via processThread function
+    // Checks if each thread is created successfully
+    for (i = 0; i < n; i++) {
+        if (pthread_create(&processes[i].thread, NULL, processThread, &processes[i]) != 0) {
+            fprintf(stderr, "Error creating process thread %d\n", i + 1);
+            return 1;
+        }
+    }
+
+    // When a process a been scheduled, executed, and completed,
+    // that process's thread will finish.
+    // Hence, when all processes are done, then only the scheduler thread will finish.
+    // When scheduler is done, the scheduler thread will join back to the main thread
+    pthread_join(scheduler, NULL);
+
+    // Joins all process threads back to main thread
+    for (i = 0; i < n; i++) {
+        pthread_join(processes[i].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &runEnd);
+
+    // Display results
+    printResults(processes, n);
+    
+    // Display Gantt chart
+    printGanttChart(gantt, ganttSize);
+
+    // Display how fast the simulation ran
+    printSimulationSpeed(globalCurrentTime, elapsedSeconds(runStart, runEnd));
+
+    // Cleanup
+    pthread_mutex_destroy(&schedulerMutex);
+    pthread_cond_destroy(&schedulerCond);
+    pthread_cond_destroy(&sliceDoneCond);
+    free(processes);
+
+    return 0;
+}
+
+// Prompt for the number of processes and each process's Arrival and Burst Time
+// Returns the number of processes, or -1 if memory could not be allocated
+int readProcessesInteractively(void) {
+    int n, i;
+
     // Input validation for number of processes
     do {
         printf("Enter number of processes (1-%d): ", MAX_PROC);
@@ -101,8 +211,12 @@ int main() {
     // Repeat until valid input is received
     } while (n < 1 || n > MAX_PROC);
 
-    // Set global number of processes
-    numProcesses = n;
+    // Allocate the Process table
+    processes = calloc(n, sizeof(Process));
+    if (processes == NULL) {
+        fprintf(stderr, "Error allocating memory for %d processes\n", n);
+        return -1;
+    }
 
     // Input arrival and burst times with validation
     printf("\nEnter arrival and burst times:\n");
@@ -162,58 +276,36 @@ int main() {
         processes[i].hasStarted = 0;
     }
 
-    // Sort processes by arrival time
-    sortByArrival(processes, n);
-
-    printf("\n======================================\n");
-    printf("  Execution Timeline (PREEMPTIVE)\n");
-    printf("======================================\n");
-    printf("Note: SRTF allows preemption - processes can be interrupted\n");
-    printf("      when a shorter job arrives.\n");
-    printf("Multithreading: Each process runs in its own thread,\n");
-    printf("                coordinated by the scheduler thread.\n\n");
-
-    // Create pthread_t variable for scheduler
-    pthread_t scheduler;
+    return n;
+}
 
-    // Creates and runs the scheduler thread
-    // Checks if there is an error when creating the scheduler thread
-    if (pthread_create(&scheduler, NULL, schedulerThread, NULL) != 0) {
-        fprintf(stderr, "Error creating scheduler thread\n");
-        return 1;
+// Load every process from a trace file (see trace_reader.h for the format)
+// Returns the number of processes, or -1 on error
+int loadProcessesFromTrace(const char *path) {
+    Trace trace;
+    int n = traceLoad(path, &trace);
+    if (n < 0) {
+        return -1;
     }
 
-    // Create process threads and runs the processes via processThread function
-    // Checks if each thread is created successfully
-    for (i = 0; i < n; i++) {
-        if (pthread_create(&processes[i].thread, NULL, processThread, &processes[i]) != 0) {
-            fprintf(stderr, "Error creating process thread %d\n", i + 1);
-            return 1;
-        }
+    processes = calloc(n, sizeof(Process));
+    if (processes == NULL) {
+        fprintf(stderr, "Error allocating memory for %d processes\n", n);
+        traceFree(&trace);
+        return -1;
     }
 
-    // When a process a been scheduled, executed, and completed,
-    // that process's thread will finish.
-    // Hence, when all processes are done, then only the scheduler thread will finish.
-    // When scheduler is done, the scheduler thread will join back to the main thread
-    pthread_join(scheduler, NULL);
-
-    // Joins all process threads back to main thread
-    for (i = 0; i < n; i++) {
-        pthread_join(processes[i].thread, NULL);
+    for (int i = 0; i < n; i++) {
+        processes[i].pid = trace.records[i].pid;
+        processes[i].arrivalTime = trace.records[i].arrivalTime;
+        processes[i].burstTime = trace.records[i].burstTime;
+        processes[i].remainingTime = processes[i].burstTime;
+        processes[i].startTime = -1;
     }
 
-    // Display results
-    printResults(processes, n);
-    
-    // Display Gantt chart
-    printGanttChart(gantt, ganttSize);
-
-    // Cleanup
-    pthread_mutex_destroy(&schedulerMutex);
-    pthread_cond_destroy(&schedulerCond);
-
-    return 0;
+    traceFree(&trace);
+    printf("Loaded %d processes from %s\n", n, path);
+    return n;
 }
 
 // Scheduler thread function to coordinate the process execution
@@ -306,11 +398,19 @@ void *schedulerThread(void *arg) {
 
         // Wake up the selected process
         pthread_cond_broadcast(&schedulerCond);
+
+        // Wait until the process has run its time unit
+        // pthread_cond_wait releases the mutex so the process thread can proceed
+        while (globalCurrentProcess != -1) {
+            pthread_cond_wait(&sliceDoneCond, &schedulerMutex);
+        }
         pthread_mutex_unlock(&schedulerMutex);
 
-        // Small delay to simulate time slice execution
-        // 100ms delay
-        usleep(100000); 
+        // Optional delay to watch the simulation in real time
+        // Scale 1 gives the original 100ms per time unit, larger scales run faster
+        if (realtimeScale > 0) {
+            realtimeDelay(1);
+        }
     }
 
     return NULL;
@@ -319,6 +419,8 @@ void *schedulerThread(void *arg) {
 // Process thread function to represent the individual process execution
 void *processThread(void *arg) {
     Process *proc = (Process *)arg;
+    // Position of this process in processes[] (differs from pid - 1 once sorted)
+    int idx = (int)(proc - processes);
 
     // While true loop that only breaks if either:
     // scheduler stops running 
@@ -327,7 +429,7 @@ void *processThread(void *arg) {
         pthread_mutex_lock(&schedulerMutex);
 
         // Wait until this process is scheduled or scheduler stops
-        while (globalCurrentProcess != (proc->pid - 1) && schedulerRunning) {
+        while (globalCurrentProcess != idx && schedulerRunning) {
             pthread_cond_wait(&schedulerCond, &schedulerMutex);
         }
 
@@ -381,8 +483,9 @@ void *processThread(void *arg) {
                    globalCurrentTime, proc->pid, (unsigned long)pthread_self());
         }
 
-        // Reset current process
+        // Reset current process and hand control back to the scheduler
         globalCurrentProcess = -1;
+        pthread_cond_signal(&sliceDoneCond);
 
         pthread_mutex_unlock(&schedulerMutex);
     }
@@ -390,28 +493,24 @@ void *processThread(void *arg) {
     return NULL;
 }
 
-// Sort processes by arrival time (improved bubble sort)
-// Added swapped flag for optimisation
-// Improved bubble sort runtime:
-// Best case: O(n)
-// Worst case: O(n^2)
-// Source: Algorithms, Data Structures and Efficiency module
+// Sort processes by arrival time
+// Stable: processes with the same Arrival Time keep their input order
+// Runtime: O(n) (radix sort on an array of row indices, see arrival_sort.h);
+// each record is then moved once into the sorted order
 void sortByArrival(Process proc[], int n) {
-    int i, j;
-    bool swapped = true;
-
-    for (i = 0; i < n - 1 && swapped; i++) {
-        swapped = false;
-
-        for (j = i + 1; j < n; j++) {
-            if (proc[i].arrivalTime > proc[j].arrivalTime) {
-                Process temp = proc[i];
-                proc[i] = proc[j];
-                proc[j] = temp;
-                swapped = true;
-            }
-        }
+    int *order = malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    Process *sorted = malloc((size_t)(n > 0 ? n : 1) * sizeof(Process));
+    if (order == NULL || sorted == NULL ||
+        !sortIndicesByArrival(&proc[0].arrivalTime, sizeof(Process), n, order)) {
+        fprintf(stderr, "Error allocating memory to sort %d processes\n", n);
+        exit(1);
     }
+
+    for (int i = 0; i < n; i++) sorted[i] = proc[order[i]];
+    memcpy(proc, sorted, (size_t)n * sizeof(Process));
+
+    free(sorted);
+    free(order);
 }
 
 // Find process with shortest Remaining Time that has arrived
@@ -461,6 +560,41 @@ void printResults(Process proc[], int n) {
     printf("Average Response Time = %.2f\n", totalResponse / n);
 }
 
+// Sleep for the given number of simulated time units at the --realtime pace
+// (100ms per unit / realtimeScale)
+// usleep is limited to 1,000,000 us and its count overflows for long slices
+// or small scales, so the delay is capped at REALTIME_MAX_DELAY seconds and
+// slept with nanosleep, resuming after signals
+void realtimeDelay(int units) {
+    double seconds = 0.1 * units / realtimeScale;
+    if (!(seconds < REALTIME_MAX_DELAY)) seconds = REALTIME_MAX_DELAY;
+
+    struct timespec delay, left;
+    delay.tv_sec = (time_t)seconds;
+    delay.tv_nsec = (long)((seconds - (double)delay.tv_sec) * 1e9);
+    while (nanosleep(&delay, &left) != 0 && errno == EINTR) {
+        delay = left;
+    }
+}
+
+// Seconds between two CLOCK_MONOTONIC readings
+double elapsedSeconds(struct timespec start, struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Print the achieved simulation speed
+void printSimulationSpeed(int ticks, double seconds) {
+    printf("\n======================================\n");
+    printf("  Simulation Speed\n");
+    printf("======================================\n\n");
+
+    printf("Simulated time units = %d\n", ticks);
+    printf("Wall-clock time      = %.6f s\n", seconds);
+    if (seconds > 0) {
+        printf("Ticks per second     = %.2f\n", ticks / seconds);
+    }
+}
+
 // Print Gantt chart
 void printGanttChart(GanttEntry gantt[], int size) {
     int i;
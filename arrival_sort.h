@@ -0,0 +1,114 @@
+// Stable sort of process rows by Arrival Time, shared by the simulators.
+//
+// sortIndicesByArrival(arrivalTime, stride, n, order) fills order[] with the
+// row indices 0..n-1 arranged by ascending Arrival Time; rows with the same
+// Arrival Time keep their input order. Only the index array is permuted, so
+// the caller moves each record (or column) once afterwards instead of
+// swapping whole structs (with their thread handles) on every comparison.
+//
+// The Arrival Time of row i is read at (const char *)arrivalTime + i * stride,
+// so the same call sorts a column (stride sizeof(int)) or an array of structs
+// (arrivalTime = &proc[0].arrivalTime, stride sizeof(proc[0])).
+//
+// Large inputs use an LSD radix sort: 4 counting passes over 8-bit digits of
+// (key, index) pairs, O(n) overall. Digits that are the same in every key
+// (e.g. the high bytes when all arrivals are small) are skipped. Up to
+// ARRIVAL_SORT_SMALL rows an insertion sort is faster than clearing the
+// digit counts.
+
+#ifndef ARRIVAL_SORT_H
+#define ARRIVAL_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define ARRIVAL_SORT_SMALL 64     // Insertion sort up to this many rows
+#define ARRIVAL_SORT_RADIX 256    // Buckets per counting pass (8-bit digits)
+
+// Arrival Time of row i
+static inline int arrivalSortKey(const int *arrivalTime, size_t stride, int i) {
+    return *(const int *)((const char *)arrivalTime + (size_t)i * stride);
+}
+
+// Returns false if the radix sort's scratch buffers cannot be allocated
+static inline bool sortIndicesByArrival(const int *arrivalTime, size_t stride, int n, int *order) {
+    for (int i = 0; i < n; i++) order[i] = i;
+
+    if (n <= ARRIVAL_SORT_SMALL) {
+        // Insertion sort; moving only past strictly later arrivals keeps it stable
+        for (int i = 1; i < n; i++) {
+            int row = order[i];
+            int key = arrivalSortKey(arrivalTime, stride, row);
+            int j = i - 1;
+            while (j >= 0 && arrivalSortKey(arrivalTime, stride, order[j]) > key) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = row;
+        }
+        return true;
+    }
+
+    // (key, index) pairs in two buffers; each pass scatters from one into the other
+    // Flipping the sign bit makes unsigned digit order match signed int order
+    unsigned *keys = malloc((size_t)n * 2 * sizeof(unsigned));
+    int *rows = malloc((size_t)n * sizeof(int));
+    size_t (*counts)[ARRIVAL_SORT_RADIX] = calloc(4, sizeof(*counts));
+    if (keys == NULL || rows == NULL || counts == NULL) {
+        free(keys);
+        free(rows);
+        free(counts);
+        return false;
+    }
+    unsigned *srcKeys = keys, *dstKeys = keys + n;
+    int *srcRows = order, *dstRows = rows;
+
+    // One read of the input builds the histograms of all four digits
+    for (int i = 0; i < n; i++) {
+        unsigned key = (unsigned)arrivalSortKey(arrivalTime, stride, i) ^ 0x80000000u;
+        srcKeys[i] = key;
+        for (int digit = 0; digit < 4; digit++) {
+            counts[digit][(key >> (8 * digit)) & 0xFF]++;
+        }
+    }
+
+    for (int digit = 0; digit < 4; digit++) {
+        int shift = 8 * digit;
+        size_t *count = counts[digit];
+        // Every key has the same digit here: the pass would not move anything
+        if (count[(srcKeys[0] >> shift) & 0xFF] == (size_t)n) continue;
+
+        // Counts become the first output slot of each bucket
+        size_t next = 0;
+        for (int b = 0; b < ARRIVAL_SORT_RADIX; b++) {
+            size_t bucket = count[b];
+            count[b] = next;
+            next += bucket;
+        }
+        // Scanning the input in order keeps equal digits in order (stable)
+        for (int i = 0; i < n; i++) {
+            size_t slot = count[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[slot] = srcKeys[i];
+            dstRows[slot] = srcRows[i];
+        }
+        unsigned *tempKeys = srcKeys;
+        srcKeys = dstKeys;
+        dstKeys = tempKeys;
+        int *tempRows = srcRows;
+        srcRows = dstRows;
+        dstRows = tempRows;
+    }
+
+    // After an odd number of passes the result sits in the scratch buffer
+    if (srcRows != order) {
+        for (int i = 0; i < n; i++) order[i] = srcRows[i];
+    }
+
+    free(keys);
+    free(rows);
+    free(counts);
+    return true;
+}
+
+#endif
@@ -0,0 +1,649 @@
+// Benchmark harness: runs every scheduler program over a fixed suite of
+// seeded workloads and writes the measurements as a JSON report, so two
+// versions of the simulators can be compared by diffing their reports.
+//
+// The suite is every combination of a size (10, 1k, 100k and 1M processes)
+// and a load profile:
+//     light   Poisson arrivals at 50% CPU utilisation
+//     heavy   Poisson arrivals at 95% CPU utilisation
+//     bursty  arrivals in clumps of ~20 processes at the same time, 80% overall
+// Bursts are exponential with mean 5 time units. Each workload is generated
+// from its own splitmix64 stream derived from --seed, its profile and its
+// size, so the same seed always produces the same files.
+//
+// Each program runs as a child process with its output sent to /dev/null.
+// Programs with a --trace option read the workload as a trace file; the
+// interactive ones (up to 10 processes) get the answers to their prompts
+// on stdin. The harness records for each run:
+//     wall_s        wall-clock time, best of --repeat runs
+//     events_per_s  simulated events per second, where a workload of N
+//                   processes has 2N events (each arrival and completion)
+//     units_per_s   simulated time units per second
+//     peak_rss_kb   peak resident set size (getrusage of the child)
+//     allocations   malloc-family calls and bytes, counted by bench_alloc.so
+//                   when it is found (see bench_alloc.c); null otherwise
+// A run that exits with an error, or is still running after --timeout
+// seconds, is reported as failed/timeout, and the larger workloads of the
+// same profile are skipped for that program.
+//
+// Terminal code:
+// gcc -O2 bench.c -o bench -lm
+// gcc -O2 -shared -fPIC bench_alloc.c -o bench_alloc.so
+// ./bench --out=bench.json --sizes=10,1000,100000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#define MAX_SIZES 8                 // Entries accepted by --sizes
+#define MAX_ENGINE_ARGS 4           // Fixed options passed to a program
+#define PROMPT_MAX_PROCS 10         // Largest workload the interactive programs accept
+#define BURST_MEAN 5.0              // Mean burst time of every profile
+#define BURSTY_CLUMP 20.0           // Mean number of processes per clump (bursty profile)
+
+// How a program reads its workload
+typedef enum {
+    INPUT_TRACE,           // --trace=FILE
+    INPUT_PROMPTS          // Answers to "number of processes", then arrival and burst of each
+} InputMode;
+
+// One scheduler program under test
+typedef struct {
+    const char *name;                      // Name in the report
+    const char *binary;                    // Executable, relative to --bin-dir
+    InputMode input;
+    int maxProcs;                          // Largest workload it accepts
+    const char *args[MAX_ENGINE_ARGS + 1]; // Fixed options, NULL-terminated
+} Engine;
+
+// Load profiles
+typedef struct {
+    const char *name;
+    double utilisation;    // Offered load: mean burst / mean inter-arrival time
+    bool clumped;          // Arrivals come in clumps at the same time unit
+} Profile;
+
+// Result of one program on one workload
+typedef enum {
+    RUN_OK,
+    RUN_FAILED,            // Non-zero exit status or killed by a signal
+    RUN_TIMEOUT,           // Killed after --timeout seconds
+    RUN_SKIPPED,           // Not run (too large for the program, or a smaller run failed)
+    RUN_MISSING            // Executable not found
+} RunStatus;
+
+typedef struct {
+    RunStatus status;
+    const char *reason;    // Why a run was skipped or failed
+    int exitCode;          // Exit status, or the signal number when killed
+    double wallSeconds;    // Best wall-clock time over the repeats
+    double meanSeconds;    // Mean wall-clock time over the repeats
+    double userSeconds;    // CPU time of the best run
+    double systemSeconds;
+    long peakRssKb;        // Largest peak RSS over the repeats
+    long allocations;      // -1 when not counted
+    long allocatedBytes;
+} RunResult;
+
+// A generated workload
+typedef struct {
+    const Profile *profile;
+    int procs;                 // Number of processes
+    long span;                 // Time units until the last completion (any work-conserving policy)
+    char tracePath[PATH_MAX];  // pid,arrival,burst file
+    char promptPath[PATH_MAX]; // Answers to the prompts, only for small workloads
+} Workload;
+
+static const Engine engines[] = {
+    {"STRF",                          "STRF",                          INPUT_TRACE,   INT_MAX,          {"--summary", "--pool", NULL}},
+    {"STRF-event",                    "STRF",                          INPUT_TRACE,   INT_MAX,          {"--summary", "--pool", "--event-driven", NULL}},
+    {"TEMP",                          "TEMP",                          INPUT_TRACE,   INT_MAX,          {NULL}},
+    {"Shortest_Time_Remaining_First", "Shortest_Time_Remaining_First", INPUT_PROMPTS, PROMPT_MAX_PROCS, {NULL}},
+    {"Shawn_STRF",                    "Shawn_STRF",                    INPUT_PROMPTS, PROMPT_MAX_PROCS, {NULL}},
+    {"sjf",                           "sjf",                           INPUT_TRACE,   INT_MAX,          {NULL}},
+};
+#define NUM_ENGINES (int)(sizeof(engines) / sizeof(engines[0]))
+
+static const Profile profiles[] = {
+    {"light",  0.50, false},
+    {"heavy",  0.95, false},
+    {"bursty", 0.80, true},
+};
+#define NUM_PROFILES (int)(sizeof(profiles) / sizeof(profiles[0]))
+
+// Benchmark configuration
+int sizes[MAX_SIZES] = {10, 1000, 100000, 1000000};
+int numSizes = 4;
+uint64_t seed = 1;                         // Base RNG seed of every workload
+int timeoutSeconds = 60;                   // Per-run limit
+int repeats = 1;                           // Runs of each (program, workload); the best is reported
+const char *outFile = "bench.json";        // JSON report
+const char *binDir = ".";                  // Where the programs are
+const char *allocShim = NULL;              // bench_alloc.so, NULL = look in binDir
+const char *engineFilter = NULL;           // Comma-separated names from --engines, NULL = all
+const char *profileFilter = NULL;          // Comma-separated names from --profiles, NULL = all
+bool keepFiles = false;                    // Keep the generated workloads
+char workDir[PATH_MAX / 2];                // Temporary directory of the workloads
+
+// Function prototypes
+bool parseArguments(int argc, char *argv[]);
+bool parseSizes(const char *list);
+void printUsage(const char *program);
+bool listContains(const char *list, const char *name);
+uint64_t rngNext(uint64_t *state);
+double rngUniform(uint64_t *state);
+bool generateWorkload(Workload *workload, const Profile *profile, int procs);
+void runEngine(const Engine *engine, const Workload *workload, RunResult *result);
+bool runOnce(const Engine *engine, const Workload *workload, RunResult *result,
+             double *seconds, struct rusage *usage, long *allocations, long *bytes);
+const char *statusName(RunStatus status);
+void writeJsonString(FILE *out, const char *text);
+bool writeReport(Workload workloads[], int numWorkloads, RunResult *results);
+void removeWorkloads(Workload workloads[], int numWorkloads);
+
+int main(int argc, char *argv[]) {
+    if (!parseArguments(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    static char shimPath[PATH_MAX];
+    if (allocShim == NULL) {
+        snprintf(shimPath, sizeof(shimPath), "%s/bench_alloc.so", binDir);
+        if (access(shimPath, R_OK) == 0) allocShim = shimPath;
+    }
+    if (allocShim != NULL && allocShim[0] != '/') {
+        // LD_PRELOAD paths without a slash are searched for like libraries
+        static char absolute[PATH_MAX];
+        if (realpath(allocShim, absolute) == NULL) {
+            fprintf(stderr, "Error: cannot find allocation counter '%s'\n", allocShim);
+            return 1;
+        }
+        allocShim = absolute;
+    }
+
+    const char *tmp = getenv("TMPDIR");
+    if (tmp == NULL || strlen(tmp) > sizeof(workDir) - 16) tmp = "/tmp";
+    snprintf(workDir, sizeof(workDir), "%s/bench.XXXXXX", tmp);
+    if (mkdtemp(workDir) == NULL) {
+        fprintf(stderr, "Error creating a temporary directory: %s\n", strerror(errno));
+        return 1;
+    }
+
+    // Generate the suite
+    Workload *workloads = calloc((size_t)NUM_PROFILES * numSizes, sizeof(Workload));
+    RunResult *results = calloc((size_t)NUM_PROFILES * numSizes * NUM_ENGINES, sizeof(RunResult));
+    if (workloads == NULL || results == NULL) {
+        fprintf(stderr, "Error allocating memory for the results\n");
+        return 1;
+    }
+    int numWorkloads = 0;
+    for (int p = 0; p < NUM_PROFILES; p++) {
+        if (profileFilter != NULL && !listContains(profileFilter, profiles[p].name)) continue;
+        for (int s = 0; s < numSizes; s++) {
+            if (!generateWorkload(&workloads[numWorkloads], &profiles[p], sizes[s])) {
+                removeWorkloads(workloads, numWorkloads);
+                return 1;
+            }
+            numWorkloads++;
+        }
+    }
+    if (numWorkloads == 0) {
+        fprintf(stderr, "No known profile in --profiles=%s\n", profileFilter);
+        removeWorkloads(workloads, 0);
+        return 1;
+    }
+
+    printf("%-30s %-16s %10s %14s %12s %12s\n", "Program", "Workload", "Wall (s)", "Events/s", "Peak RSS KB", "Allocations");
+    printf("-----------------------------------------------------------------------------------------------------\n");
+
+    // Workloads of a profile are in increasing size, so a failure skips the rest
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        const Engine *engine = &engines[e];
+        if (engineFilter != NULL && !listContains(engineFilter, engine->name)) continue;
+        const Profile *failedProfile = NULL;
+        for (int w = 0; w < numWorkloads; w++) {
+            const Workload *workload = &workloads[w];
+            RunResult *result = &results[(size_t)w * NUM_ENGINES + e];
+            if (workload->procs > engine->maxProcs) {
+                *result = (RunResult){.status = RUN_SKIPPED, .reason = "more processes than the program accepts"};
+                continue;
+            }
+            if (workload->profile == failedProfile) {
+                *result = (RunResult){.status = RUN_SKIPPED, .reason = "a smaller workload failed or timed out"};
+                continue;
+            }
+
+            runEngine(engine, workload, result);
+            if (result->status == RUN_MISSING) {
+                fprintf(stderr, "Skipping %s: %s/%s not found\n", engine->name, binDir, engine->binary);
+                for (int rest = w + 1; rest < numWorkloads; rest++) {
+                    results[(size_t)rest * NUM_ENGINES + e] = *result;
+                }
+                break;
+            }
+            if (result->status != RUN_OK) failedProfile = workload->profile;
+
+            char label[32];
+            snprintf(label, sizeof(label), "%s-%d", workload->profile->name, workload->procs);
+            if (result->status == RUN_OK) {
+                char allocations[24] = "-";
+                if (result->allocations >= 0) snprintf(allocations, sizeof(allocations), "%ld", result->allocations);
+                printf("%-30s %-16s %10.4f %14.0f %12ld %12s\n", engine->name, label, result->wallSeconds,
+                       result->wallSeconds > 0 ? 2.0 * workload->procs / result->wallSeconds : 0.0,
+                       result->peakRssKb, allocations);
+            } else {
+                printf("%-30s %-16s %10s (%s)\n", engine->name, label, statusName(result->status), result->reason);
+            }
+            fflush(stdout);
+        }
+    }
+
+    bool written = writeReport(workloads, numWorkloads, results);
+    if (!keepFiles) removeWorkloads(workloads, numWorkloads);
+    else printf("\nWorkloads kept in %s\n", workDir);
+    free(workloads);
+    free(results);
+    if (!written) return 1;
+    printf("\nReport written to %s\n", outFile);
+    return 0;
+}
+
+// Parse command-line options
+// Returns false if an option is invalid
+bool parseArguments(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        char *end;
+        if (strncmp(argv[i], "--out=", 6) == 0) {
+            outFile = argv[i] + 6;
+        } else if (strncmp(argv[i], "--sizes=", 8) == 0) {
+            if (!parseSizes(argv[i] + 8)) return false;
+        } else if (strncmp(argv[i], "--profiles=", 11) == 0) {
+            profileFilter = argv[i] + 11;
+        } else if (strncmp(argv[i], "--engines=", 10) == 0) {
+            engineFilter = argv[i] + 10;
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, &end, 10);
+            if (*end != '\0') {
+                fprintf(stderr, "Invalid seed: %s\n", argv[i] + 7);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--timeout=", 10) == 0) {
+            timeoutSeconds = (int)strtol(argv[i] + 10, &end, 10);
+            if (*end != '\0' || timeoutSeconds < 1) {
+                fprintf(stderr, "Invalid timeout: %s\n", argv[i] + 10);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeats = (int)strtol(argv[i] + 9, &end, 10);
+            if (*end != '\0' || repeats < 1 || repeats > 1000) {
+                fprintf(stderr, "Invalid number of repeats: %s\n", argv[i] + 9);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--bin-dir=", 10) == 0) {
+            binDir = argv[i] + 10;
+        } else if (strncmp(argv[i], "--alloc-shim=", 13) == 0) {
+            allocShim = argv[i] + 13;
+        } else if (strcmp(argv[i], "--keep") == 0) {
+            keepFiles = true;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+
+    for (int e = 0; engineFilter != NULL && e < NUM_ENGINES; e++) {
+        if (listContains(engineFilter, engines[e].name)) return true;
+    }
+    if (engineFilter != NULL) {
+        fprintf(stderr, "No known program in --engines=%s\n", engineFilter);
+        return false;
+    }
+    return true;
+}
+
+// Parse a comma-separated list of workload sizes
+bool parseSizes(const char *list) {
+    numSizes = 0;
+    const char *p = list;
+    while (*p != '\0') {
+        char *end;
+        long size = strtol(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0') || size < 1 || size > 100000000) {
+            fprintf(stderr, "Invalid workload sizes: %s\n", list);
+            return false;
+        }
+        if (numSizes == MAX_SIZES) {
+            fprintf(stderr, "At most %d workload sizes\n", MAX_SIZES);
+            return false;
+        }
+        sizes[numSizes++] = (int)size;
+        p = *end == ',' ? end + 1 : end;
+    }
+    // Ascending order, so a failure can skip the larger sizes
+    for (int i = 1; i < numSizes; i++) {
+        for (int j = i; j > 0 && sizes[j - 1] > sizes[j]; j--) {
+            int temp = sizes[j];
+            sizes[j] = sizes[j - 1];
+            sizes[j - 1] = temp;
+        }
+    }
+    return numSizes > 0;
+}
+
+// Print the supported command-line options
+void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --out=FILE         JSON report (default bench.json)\n");
+    fprintf(stderr, "  --sizes=N,N,...    Workload sizes in processes (default 10,1000,100000,1000000)\n");
+    fprintf(stderr, "  --profiles=LIST    Load profiles to run: light, heavy, bursty (default all)\n");
+    fprintf(stderr, "  --engines=LIST     Programs to run (default all):");
+    for (int e = 0; e < NUM_ENGINES; e++) fprintf(stderr, "%s %s", e > 0 ? "," : "", engines[e].name);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --seed=S           Base RNG seed of the workloads (default 1)\n");
+    fprintf(stderr, "  --timeout=SEC      Stop a run after SEC seconds (default 60)\n");
+    fprintf(stderr, "  --repeat=R         Run each program R times per workload, report the best\n");
+    fprintf(stderr, "  --bin-dir=DIR      Directory of the program executables (default .)\n");
+    fprintf(stderr, "  --alloc-shim=SO    Allocation counter to preload (default DIR/bench_alloc.so)\n");
+    fprintf(stderr, "  --keep             Keep the generated workload files\n");
+}
+
+// True if name is one of the comma-separated entries of list
+bool listContains(const char *list, const char *name) {
+    size_t length = strlen(name);
+    const char *p = list;
+    while (p != NULL && *p != '\0') {
+        const char *comma = strchr(p, ',');
+        size_t entry = comma != NULL ? (size_t)(comma - p) : strlen(p);
+        if (entry == length && strncmp(p, name, length) == 0) return true;
+        p = comma != NULL ? comma + 1 : NULL;
+    }
+    return false;
+}
+
+// splitmix64: small, fast, and good enough to seed and drive each workload
+uint64_t rngNext(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform double in (0, 1]
+double rngUniform(uint64_t *state) {
+    return (double)((rngNext(state) >> 11) + 1) / 9007199254740992.0;
+}
+
+// Write the trace file (and, for small sizes, the prompt answers) of one workload
+bool generateWorkload(Workload *workload, const Profile *profile, int procs) {
+    workload->profile = profile;
+    workload->procs = procs;
+    snprintf(workload->tracePath, sizeof(workload->tracePath), "%s/%s-%d.txt", workDir, profile->name, procs);
+    workload->promptPath[0] = '\0';
+    if (procs <= PROMPT_MAX_PROCS) {
+        snprintf(workload->promptPath, sizeof(workload->promptPath), "%s/%s-%d.in", workDir, profile->name, procs);
+    }
+
+    FILE *trace = fopen(workload->tracePath, "w");
+    FILE *prompts = workload->promptPath[0] != '\0' ? fopen(workload->promptPath, "w") : NULL;
+    if (trace == NULL || (workload->promptPath[0] != '\0' && prompts == NULL)) {
+        fprintf(stderr, "Error creating workload files in %s\n", workDir);
+        if (trace != NULL) fclose(trace);
+        if (prompts != NULL) fclose(prompts);
+        return false;
+    }
+
+    // The workload's stream depends only on the seed, the profile and the size
+    uint64_t state = seed;
+    state = rngNext(&state) ^ (uint64_t)(profile - profiles) * 0xD1B54A32D192ED03ULL ^ (uint64_t)procs * 0x9E6C63D0676A9A99ULL;
+
+    // Mean time between arrivals (clumps for the bursty profile) for the target load
+    double gap = BURST_MEAN / profile->utilisation;
+    if (profile->clumped) gap *= BURSTY_CLUMP;
+
+    fprintf(trace, "pid,arrival,burst\n");
+    if (prompts != NULL) fprintf(prompts, "%d\n", procs);
+    double clock = 0;
+    long end = 0;
+    for (int i = 0; i < procs; i++) {
+        if (!profile->clumped || rngUniform(&state) < 1.0 / BURSTY_CLUMP) {
+            clock += -log(rngUniform(&state)) * gap;
+        }
+        int arrival = clock < 1e9 ? (int)clock : 1000000000;
+        double burst = -log(rngUniform(&state)) * BURST_MEAN;
+        int burstTime = burst < 1 ? 1 : (burst > 1e6 ? 1000000 : (int)ceil(burst));
+
+        fprintf(trace, "%d,%d,%d\n", i + 1, arrival, burstTime);
+        if (prompts != NULL) fprintf(prompts, "%d %d\n", arrival, burstTime);
+        // Arrivals are in order, so this is the finish time of any work-conserving schedule
+        end = (arrival > end ? arrival : end) + burstTime;
+    }
+    workload->span = end;
+
+    bool ok = !ferror(trace) && (prompts == NULL || !ferror(prompts));
+    if (fclose(trace) != 0) ok = false;
+    if (prompts != NULL && fclose(prompts) != 0) ok = false;
+    if (!ok) fprintf(stderr, "Error writing workload files in %s\n", workDir);
+    return ok;
+}
+
+// Run engine on workload `repeats` times and keep the best
+void runEngine(const Engine *engine, const Workload *workload, RunResult *result) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", binDir, engine->binary);
+    if (access(path, X_OK) != 0) {
+        *result = (RunResult){.status = RUN_MISSING, .reason = "executable not found"};
+        return;
+    }
+
+    *result = (RunResult){.status = RUN_OK, .allocations = -1, .allocatedBytes = -1};
+    double total = 0;
+    for (int r = 0; r < repeats; r++) {
+        double seconds;
+        struct rusage usage;
+        long allocations, bytes;
+        if (!runOnce(engine, workload, result, &seconds, &usage, &allocations, &bytes)) return;
+
+        total += seconds;
+        if (r == 0 || seconds < result->wallSeconds) {
+            result->wallSeconds = seconds;
+            result->userSeconds = (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1e6;
+            result->systemSeconds = (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1e6;
+        }
+        if (usage.ru_maxrss > result->peakRssKb) result->peakRssKb = usage.ru_maxrss;
+        // The programs are deterministic, so every run allocates the same
+        result->allocations = allocations;
+        result->allocatedBytes = bytes;
+    }
+    result->meanSeconds = total / repeats;
+}
+
+// Run engine on workload once
+// Returns false (with result->status set) if the run failed or timed out
+bool runOnce(const Engine *engine, const Workload *workload, RunResult *result,
+             double *seconds, struct rusage *usage, long *allocations, long *bytes) {
+    char path[PATH_MAX], traceOption[PATH_MAX + 8], allocPath[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", binDir, engine->binary);
+    snprintf(traceOption, sizeof(traceOption), "--trace=%s", workload->tracePath);
+    snprintf(allocPath, sizeof(allocPath), "%s/alloc.txt", workDir);
+    unlink(allocPath);
+
+    const char *argv[MAX_ENGINE_ARGS + 3];
+    int argc = 0;
+    argv[argc++] = path;
+    for (int a = 0; engine->args[a] != NULL; a++) argv[argc++] = engine->args[a];
+    if (engine->input == INPUT_TRACE) argv[argc++] = traceOption;
+    argv[argc] = NULL;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t child = fork();
+    if (child < 0) {
+        result->status = RUN_FAILED;
+        result->reason = "fork failed";
+        return false;
+    }
+    if (child == 0) {
+        const char *input = engine->input == INPUT_PROMPTS ? workload->promptPath : "/dev/null";
+        int in = open(input, O_RDONLY);
+        int out = open("/dev/null", O_WRONLY);
+        if (in < 0 || out < 0) _exit(127);
+        dup2(in, STDIN_FILENO);
+        dup2(out, STDOUT_FILENO);
+        dup2(out, STDERR_FILENO);
+        if (allocShim != NULL) {
+            setenv("LD_PRELOAD", allocShim, 1);
+            setenv("BENCH_ALLOC_FILE", allocPath, 1);
+        }
+        // The pending alarm survives exec, and its default action ends the program
+        alarm((unsigned)timeoutSeconds);
+        execv(path, (char *const *)argv);
+        _exit(127);
+    }
+
+    int status;
+    while (wait4(child, &status, 0, usage) < 0) {
+        if (errno != EINTR) {
+            result->status = RUN_FAILED;
+            result->reason = "wait failed";
+            return false;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    *seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    if (WIFSIGNALED(status)) {
+        result->exitCode = WTERMSIG(status);
+        result->status = WTERMSIG(status) == SIGALRM ? RUN_TIMEOUT : RUN_FAILED;
+        result->reason = WTERMSIG(status) == SIGALRM ? "time limit reached" : "killed by a signal";
+        return false;
+    }
+    if (WEXITSTATUS(status) != 0) {
+        result->exitCode = WEXITSTATUS(status);
+        result->status = RUN_FAILED;
+        result->reason = WEXITSTATUS(status) == 127 ? "could not start" : "non-zero exit status";
+        return false;
+    }
+
+    *allocations = -1;
+    *bytes = -1;
+    FILE *counts = fopen(allocPath, "r");
+    if (counts != NULL) {
+        if (fscanf(counts, "allocations=%ld bytes=%ld", allocations, bytes) != 2) {
+            *allocations = -1;
+            *bytes = -1;
+        }
+        fclose(counts);
+    }
+    return true;
+}
+
+const char *statusName(RunStatus status) {
+    switch (status) {
+        case RUN_OK:      return "ok";
+        case RUN_FAILED:  return "failed";
+        case RUN_TIMEOUT: return "timeout";
+        case RUN_SKIPPED: return "skipped";
+        case RUN_MISSING: return "missing";
+    }
+    return "unknown";
+}
+
+// Write text as a JSON string literal
+void writeJsonString(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);
+        if ((unsigned char)*c < 0x20) fprintf(out, "\\u%04x", *c);
+        else fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+// Write the JSON report: the configuration, the workloads and one entry per run
+bool writeReport(Workload workloads[], int numWorkloads, RunResult *results) {
+    FILE *out = fopen(outFile, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Error: cannot create report '%s'\n", outFile);
+        return false;
+    }
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    fprintf(out, "{\n  \"version\": 1,\n  \"seed\": %llu,\n  \"timeout_s\": %d,\n  \"repeat\": %d,\n",
+            (unsigned long long)seed, timeoutSeconds, repeats);
+    fprintf(out, "  \"host_cpus\": %ld,\n  \"allocations_counted\": %s,\n", cores, allocShim != NULL ? "true" : "false");
+
+    fprintf(out, "  \"workloads\": [\n");
+    for (int w = 0; w < numWorkloads; w++) {
+        const Workload *workload = &workloads[w];
+        fprintf(out, "    {\"profile\": \"%s\", \"procs\": %d, \"events\": %ld, \"span\": %ld}%s\n",
+                workload->profile->name, workload->procs, 2L * workload->procs, workload->span,
+                w + 1 < numWorkloads ? "," : "");
+    }
+    fprintf(out, "  ],\n  \"results\": [");
+
+    bool first = true;
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        if (engineFilter != NULL && !listContains(engineFilter, engines[e].name)) continue;
+        for (int w = 0; w < numWorkloads; w++) {
+            const Workload *workload = &workloads[w];
+            const RunResult *result = &results[(size_t)w * NUM_ENGINES + e];
+            fprintf(out, "%s\n    {\"engine\": ", first ? "" : ",");
+            writeJsonString(out, engines[e].name);
+            fprintf(out, ", \"profile\": \"%s\", \"procs\": %d, \"status\": \"%s\"",
+                    workload->profile->name, workload->procs, statusName(result->status));
+            first = false;
+
+            if (result->status != RUN_OK) {
+                fprintf(out, ", \"reason\": ");
+                writeJsonString(out, result->reason != NULL ? result->reason : "");
+                if (result->status == RUN_FAILED) fprintf(out, ", \"exit_code\": %d", result->exitCode);
+                fprintf(out, "}");
+                continue;
+            }
+            double seconds = result->wallSeconds > 0 ? result->wallSeconds : 1e-9;
+            fprintf(out, ", \"wall_s\": %.6f, \"wall_mean_s\": %.6f, \"user_s\": %.6f, \"sys_s\": %.6f",
+                    result->wallSeconds, result->meanSeconds, result->userSeconds, result->systemSeconds);
+            fprintf(out, ", \"events_per_s\": %.1f, \"units_per_s\": %.1f, \"peak_rss_kb\": %ld",
+                    2.0 * workload->procs / seconds, (double)workload->span / seconds, result->peakRssKb);
+            if (result->allocations >= 0) {
+                fprintf(out, ", \"allocations\": %ld, \"allocated_bytes\": %ld}", result->allocations, result->allocatedBytes);
+            } else {
+                fprintf(out, ", \"allocations\": null, \"allocated_bytes\": null}");
+            }
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    bool failed = ferror(out) != 0;
+    if (fclose(out) != 0) failed = true;
+    if (failed) {
+        fprintf(stderr, "Error writing report '%s'\n", outFile);
+        return false;
+    }
+    return true;
+}
+
+// Delete the generated files and the temporary directory
+void removeWorkloads(Workload workloads[], int numWorkloads) {
+    char allocPath[PATH_MAX];
+    snprintf(allocPath, sizeof(allocPath), "%s/alloc.txt", workDir);
+    unlink(allocPath);
+    for (int w = 0; w < numWorkloads; w++) {
+        unlink(workloads[w].tracePath);
+        if (workloads[w].promptPath[0] != '\0') unlink(workloads[w].promptPath);
+    }
+    rmdir(workDir);
+}
@@ -0,0 +1,78 @@
+// Allocation counter for bench.c, loaded into each simulator with LD_PRELOAD.
+//
+// Wraps malloc, calloc, realloc, posix_memalign, aligned_alloc and memalign
+// to count the calls and the bytes requested, then writes
+//     allocations=N bytes=B
+// to the file named by $BENCH_ALLOC_FILE when the program exits. Calls are
+// forwarded to glibc's __libc_* entry points, so no dlsym() is needed (dlsym
+// itself allocates). Counters are atomics: the simulators allocate from many
+// threads. Memory the programs map themselves (arenas, thread stacks) is not
+// counted.
+//
+// Terminal code:
+// gcc -O2 -shared -fPIC bench_alloc.c -o bench_alloc.so
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <errno.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static atomic_long allocationCount = 0;    // Calls that returned memory
+static atomic_long allocationBytes = 0;    // Bytes requested by those calls
+
+static void countAllocation(size_t size) {
+    atomic_fetch_add_explicit(&allocationCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&allocationBytes, (long)size, memory_order_relaxed);
+}
+
+void *malloc(size_t size) {
+    void *ptr = __libc_malloc(size);
+    if (ptr != NULL) countAllocation(size);
+    return ptr;
+}
+
+void *calloc(size_t count, size_t size) {
+    void *ptr = __libc_calloc(count, size);
+    if (ptr != NULL) countAllocation(count * size);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+    void *moved = __libc_realloc(ptr, size);
+    if (moved != NULL) countAllocation(size);
+    return moved;
+}
+
+void *memalign(size_t alignment, size_t size) {
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr != NULL) countAllocation(size);
+    return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL) return ENOMEM;
+    countAllocation(size);
+    *result = ptr;
+    return 0;
+}
+
+__attribute__((destructor))
+static void writeAllocationCounts(void) {
+    const char *path = getenv("BENCH_ALLOC_FILE");
+    if (path == NULL) return;
+    FILE *out = fopen(path, "w");
+    if (out == NULL) return;
+    fprintf(out, "allocations=%ld bytes=%ld\n",
+            atomic_load(&allocationCount), atomic_load(&allocationBytes));
+    fclose(out);
+}
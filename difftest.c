@@ -0,0 +1,996 @@
+// Differential tester for the SRTF simulators: generates random workloads,
+// runs each one through every engine and a plain reference SRTF, and
+// reports any case where an engine's per-process results or Gantt chart
+// differ from the reference, shrunk to a minimal reproducer.
+//
+// The engines are the simulators themselves, unmodified. Each source file
+// is built as a shared library (see Terminal code) and loaded once; for
+// every case this program forks and the child calls the library's main()
+// in-process. The fork is the reset: every run starts from the globals as
+// they were at load time, and a crash or hang ends only that child. The
+// case goes in on stdin, as a trace file or as the answers to the prompts,
+// and the results are read back from what the engine prints:
+//     STRF, STRF-event,              STRF.c --quiet --trace=- (with --event-driven
+//     STRF-scan, STRF-scan-event     and/or --select=scan); the Gantt chart comes
+//                                    from --gantt-json, written to descriptor 3
+//     TEMP                           TEMP.c --trace=-, ASCII Gantt chart
+//     Shortest_Time_Remaining_First  prompts, at most 10 processes, ASCII Gantt chart
+//     Shawn_STRF                     prompts, at most 10 processes; it prints how long
+//                                    each slice ran but not when, so only the order
+//                                    and length of the busy slices are compared
+// The reference is textbook SRTF: the arrived process with the least
+// Remaining Time runs; ties go to the earliest arrival, then input order.
+//
+// Compared for every process (by pid): Turnaround, Waiting and Response
+// Time (Shawn_STRF prints no Response Time). Gantt charts are compared as
+// their busy slices, with IDLE slices dropped and adjacent slices of the
+// same process merged, since the engines differ in whether they draw the
+// IDLE gap before the first arrival. A crash, a hang (--timeout), a non-zero
+// exit status or a missing result is reported as a failure.
+//
+// --huge percent of the cases are moved to the top of the int range, where
+// the sentinel and overflow bugs live: every arrival is delayed so the last
+// process completes at exactly INT_MAX, or one Burst Time is raised by as
+// much. Engines that step or draw one time unit at a time skip cases longer
+// than TICK_LIMIT.
+//
+// The threaded engines switch threads on every slice, so each run costs on
+// the order of a millisecond; --jobs runs that many engines at a time.
+//
+// A failing case is shrunk by repeatedly removing processes and lowering
+// Arrival and Burst Times while the engine still disagrees. The result is
+// printed as a trace file (for STRF --trace=FILE, TEMP --trace=FILE) and as
+// the answers to the prompts of the interactive programs.
+// Exit status: 0 if every selected engine matched the reference on every case.
+//
+// Terminal code:
+// gcc -O2 -shared -fPIC -pthread STRF.c -o STRF.so
+// gcc -O2 -shared -fPIC -pthread TEMP.c -o TEMP.so
+// gcc -O2 -shared -fPIC -pthread Shortest_Time_Remaining_First.c -o Shortest_Time_Remaining_First.so
+// gcc -O2 -shared -fPIC Shawn_STRF.c -o Shawn_STRF.so
+// gcc -O2 difftest.c -o difftest -ldl
+// ./difftest --cases=100000 --engines=STRF,STRF-event,STRF-scan,TEMP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include "gantt_log.h"
+
+#define PROMPT_MAX_PROCS 10         // MAX_PROC of the interactive programs, and the size of Shawn_STRF.c's p[]
+#define TICK_LIMIT 100000           // Longest run given to engines that step or draw one time unit at a time
+#define MAX_ENGINE_ARGS 5
+#define GANTT_FD 3                  // Descriptor behind the engines' --gantt-json=/dev/fd/3
+#define CASES_PER_BATCH 64          // Cases generated, then run in parallel, at a time
+#define METRIC_NONE INT_MIN         // Metric an engine does not print
+#define NUM_METRICS 3
+
+// How an engine's output differs from the reference
+typedef enum {
+    DIFF_NONE,
+    DIFF_FAILURE,          // The engine crashed, hung, failed or printed no results
+    DIFF_METRICS,          // A per-process time differs
+    DIFF_GANTT,            // Same times, different Gantt chart
+    NUM_DIFF_KINDS
+} DifferenceKind;
+
+// How a case is given to an engine (as in bench.c)
+typedef enum {
+    INPUT_TRACE,           // Trace file on stdin, for --trace=-
+    INPUT_PROMPTS          // Answers to the prompts on stdin
+} InputMode;
+
+// Where an engine's results are read from
+typedef enum {
+    OUTPUT_STRF,           // "Process P1: Turnaround = ..." lines, Gantt chart as JSON on GANTT_FD
+    OUTPUT_ASCII,          // "Process P1: Turnaround = ..." lines and the ASCII Gantt chart
+    OUTPUT_SHAWN           // "process 1: waiting time:..." lines, and a line per slice without its times
+} OutputFormat;
+
+// One process of a test case; its pid is its position in the case + 1
+typedef struct {
+    int arrivalTime;
+    int burstTime;
+} CaseProcess;
+
+// What an engine produced for a case
+typedef struct {
+    int *metrics;          // NUM_METRICS values per process, indexed by pid - 1
+    GanttEntry *slices;    // Busy slices, merged (see outputAddSlice)
+    int sliceCount;
+    int sliceCapacity;
+    int span;              // When the last process completed (reference only)
+    char failure[96];      // Empty unless the engine crashed, hung, failed or printed no results
+} RunOutput;
+
+// One simulator under test
+typedef struct {
+    const char *name;
+    const char *library;                        // Shared library built from its source, in --lib-dir
+    const char *args[MAX_ENGINE_ARGS + 1];      // Options, NULL-terminated
+    InputMode input;
+    OutputFormat output;
+    int maxProcs;                               // Largest case it accepts
+    int maxSpan;                                // Latest completion it can draw
+    int maxWork;                                // Largest total Burst Time it can step through
+} Engine;
+
+// Per-engine results of a test run
+typedef struct {
+    long cases;            // Cases run
+    long skipped;          // Cases larger or longer than the engine accepts
+    long mismatches;       // Cases that differed from the reference
+    CaseProcess *minimal[NUM_DIFF_KINDS];  // Shrunk reproducer of the first mismatch of each kind
+    int minimalCount[NUM_DIFF_KINDS];
+} EngineReport;
+
+// One engine run of one case
+typedef struct {
+    int engine;
+    const CaseProcess *procs;
+    int n;
+    const RunOutput *expected;
+    RunOutput *out;
+} Task;
+
+// A child running a task, and the files it reads and writes
+typedef struct {
+    pid_t child;           // 0 while the slot is free
+    Task task;
+    FILE *input;
+    FILE *output;          // stdout and stderr
+    FILE *gantt;           // GANTT_FD
+} JobSlot;
+
+// Test configuration
+long numCases = 1000;                      // Random cases to generate
+uint64_t seed = 1;                         // RNG seed
+int maxProcs = PROMPT_MAX_PROCS;           // Largest case generated
+int maxBurst = 10;                         // Largest Burst Time generated
+int hugePercent = 5;                       // Cases moved to the top of the int range
+int numJobs = 0;                           // Engines run at a time, 0 = one per CPU
+int timeoutMs = 100;                       // A run taking longer is reported as a hang
+const char *libDir = ".";                  // Where the engine libraries are
+const char *engineFilter = NULL;           // Comma-separated names from --engines, NULL = all
+
+const char *metricNames[NUM_METRICS] = {"Turnaround", "Waiting", "Response"};
+
+// Function prototypes
+bool parseArguments(int argc, char *argv[]);
+void printUsage(const char *program);
+bool listContains(const char *list, const char *name);
+bool engineSelected(int engine);
+bool loadEngines(void);
+bool openJobSlots(void);
+uint64_t rngNext(uint64_t *state);
+void generateCase(uint64_t *state, CaseProcess procs[], int *n);
+bool engineAccepts(const Engine *engine, const CaseProcess procs[], int n, int span);
+void outputReset(RunOutput *out, int n);
+void outputAddSlice(RunOutput *out, int pid, int start, int end);
+void outputSetMetrics(RunOutput *out, int pid, int completion, int arrival, int burst, int start);
+void outputCompact(const RunOutput *from, RunOutput *to);
+void runTasks(Task tasks[], int count);
+bool startTask(JobSlot *slot, const Task *task);
+void runEngineChild(JobSlot *slot);
+void finishTask(JobSlot *slot, int status);
+bool writeCaseInput(FILE *file, InputMode input, const CaseProcess procs[], int n);
+void parseOutput(JobSlot *slot);
+bool parseAsciiGantt(const char *labels, const char *markers, RunOutput *out);
+bool parseJsonGantt(FILE *file, RunOutput *out);
+DifferenceKind compareOutputs(const RunOutput *expected, const RunOutput *actual, int n, const Engine *engine,
+                              char *difference, size_t size);
+DifferenceKind caseDiffers(int engine, const CaseProcess procs[], int n, char *difference, size_t size);
+int shrinkCase(int engine, CaseProcess procs[], int n, DifferenceKind kind);
+void runReference(const CaseProcess procs[], int n, RunOutput *out);
+
+static const Engine engines[] = {
+    {"STRF",                          "STRF.so", {"--quiet", "--gantt-json=/dev/fd/3", "--trace=-"},
+     INPUT_TRACE,   OUTPUT_STRF,  INT_MAX,          INT_MAX,    TICK_LIMIT},
+    {"STRF-event",                    "STRF.so", {"--quiet", "--gantt-json=/dev/fd/3", "--event-driven", "--trace=-"},
+     INPUT_TRACE,   OUTPUT_STRF,  INT_MAX,          INT_MAX,    INT_MAX},
+    {"STRF-scan",                     "STRF.so", {"--quiet", "--gantt-json=/dev/fd/3", "--select=scan", "--trace=-"},
+     INPUT_TRACE,   OUTPUT_STRF,  INT_MAX,          INT_MAX,    TICK_LIMIT},
+    {"STRF-scan-event",               "STRF.so",
+     {"--quiet", "--gantt-json=/dev/fd/3", "--select=scan", "--event-driven", "--trace=-"},
+     INPUT_TRACE,   OUTPUT_STRF,  INT_MAX,          INT_MAX,    INT_MAX},
+    {"TEMP",                          "TEMP.so", {"--trace=-"},
+     INPUT_TRACE,   OUTPUT_ASCII, INT_MAX,          TICK_LIMIT, INT_MAX},
+    {"Shortest_Time_Remaining_First", "Shortest_Time_Remaining_First.so", {NULL},
+     INPUT_PROMPTS, OUTPUT_ASCII, PROMPT_MAX_PROCS, TICK_LIMIT, INT_MAX},
+    // Jumps at most 9999 time units per line it prints
+    {"Shawn_STRF",                    "Shawn_STRF.so", {NULL},
+     INPUT_PROMPTS, OUTPUT_SHAWN, PROMPT_MAX_PROCS, INT_MAX,    TICK_LIMIT},
+};
+#define NUM_ENGINES (int)(sizeof(engines) / sizeof(engines[0]))
+
+int (*engineMain[NUM_ENGINES])(int argc, char *argv[]);   // Each library's main(), from loadEngines
+JobSlot *slots;                                             // numJobs of them
+
+// Scratch outputs for generateCase, caseDiffers and compareOutputs
+RunOutput expectedOutput, actualOutput, compactOutput;
+
+int main(int argc, char *argv[]) {
+    if (!parseArguments(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!loadEngines() || !openJobSlots()) return 1;
+
+    CaseProcess *cases = malloc((size_t)CASES_PER_BATCH * maxProcs * sizeof(CaseProcess));
+    int caseSizes[CASES_PER_BATCH];
+    RunOutput *expected = calloc(CASES_PER_BATCH, sizeof(RunOutput));
+    RunOutput *actual = calloc((size_t)CASES_PER_BATCH * NUM_ENGINES, sizeof(RunOutput));
+    Task *tasks = malloc((size_t)CASES_PER_BATCH * NUM_ENGINES * sizeof(Task));
+    EngineReport reports[NUM_ENGINES];
+    memset(reports, 0, sizeof(reports));
+    if (cases == NULL || expected == NULL || actual == NULL || tasks == NULL) {
+        fprintf(stderr, "Error allocating memory for %d cases of %d processes\n", CASES_PER_BATCH, maxProcs);
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    uint64_t state = seed;
+    char difference[256];
+    for (long first = 0; first < numCases; first += CASES_PER_BATCH) {
+        // Generate a batch of cases and queue a run of every engine that accepts them
+        int batch = numCases - first < CASES_PER_BATCH ? (int)(numCases - first) : CASES_PER_BATCH;
+        int numTasks = 0;
+        for (int c = 0; c < batch; c++) {
+            CaseProcess *procs = &cases[(size_t)c * maxProcs];
+            generateCase(&state, procs, &caseSizes[c]);
+            outputReset(&expected[c], caseSizes[c]);
+            runReference(procs, caseSizes[c], &expected[c]);
+            for (int e = 0; e < NUM_ENGINES; e++) {
+                if (!engineSelected(e)) continue;
+                if (!engineAccepts(&engines[e], procs, caseSizes[c], expected[c].span)) {
+                    reports[e].skipped++;
+                    continue;
+                }
+                reports[e].cases++;
+                RunOutput *out = &actual[c * NUM_ENGINES + e];
+                outputReset(out, caseSizes[c]);
+                tasks[numTasks++] = (Task){e, procs, caseSizes[c], &expected[c], out};
+            }
+        }
+        runTasks(tasks, numTasks);
+
+        // Check them in order, so the report does not depend on --jobs
+        for (int t = 0; t < numTasks; t++) {
+            const Task *task = &tasks[t];
+            EngineReport *report = &reports[task->engine];
+            DifferenceKind kind = compareOutputs(task->expected, task->out, task->n, &engines[task->engine],
+                                                 difference, sizeof(difference));
+            if (kind == DIFF_NONE) continue;
+            report->mismatches++;
+
+            // Keep a shrunk copy of the first failing case of each kind, so
+            // one kind of bug does not hide the others
+            if (report->minimal[kind] == NULL) {
+                report->minimal[kind] = malloc((size_t)task->n * sizeof(CaseProcess));
+                if (report->minimal[kind] == NULL) {
+                    fprintf(stderr, "Error allocating memory for a failing case\n");
+                    return 1;
+                }
+                memcpy(report->minimal[kind], task->procs, (size_t)task->n * sizeof(CaseProcess));
+                report->minimalCount[kind] = shrinkCase(task->engine, report->minimal[kind], task->n, kind);
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("======================================\n");
+    printf("  SRTF Differential Test\n");
+    printf("======================================\n\n");
+    printf("Cases                = %ld (1-%d processes, bursts 1-%d, %d%% near INT_MAX)\n",
+           numCases, maxProcs, maxBurst, hugePercent);
+    printf("Seed                 = %llu\n", (unsigned long long)seed);
+    printf("Jobs                 = %d\n", numJobs);
+    printf("Wall-clock time      = %.3f s (%.0f cases/s)\n\n", seconds, seconds > 0 ? numCases / seconds : 0.0);
+
+    printf("%-30s %10s %10s %12s\n", "Engine", "Cases", "Skipped", "Mismatches");
+    printf("-----------------------------------------------------------------\n");
+    bool allMatched = true;
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        if (!engineSelected(e)) continue;
+        printf("%-30s %10ld %10ld %12ld\n", engines[e].name, reports[e].cases, reports[e].skipped, reports[e].mismatches);
+        if (reports[e].mismatches > 0) allMatched = false;
+    }
+
+    // Minimal reproducers
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        for (int kind = DIFF_FAILURE; kind < NUM_DIFF_KINDS; kind++) {
+            const CaseProcess *minimal = reports[e].minimal[kind];
+            int count = reports[e].minimalCount[kind];
+            if (minimal == NULL) continue;
+            caseDiffers(e, minimal, count, difference, sizeof(difference));
+            printf("\n%s: minimal failing case (%d process%s)\n", engines[e].name, count, count == 1 ? "" : "es");
+            printf("  %s\n", difference);
+            printf("  Trace file:\n    pid,arrival,burst\n");
+            for (int i = 0; i < count; i++) {
+                printf("    %d,%d,%d\n", i + 1, minimal[i].arrivalTime, minimal[i].burstTime);
+            }
+            printf("  Prompt answers: %d", count);
+            for (int i = 0; i < count; i++) {
+                printf("  %d %d", minimal[i].arrivalTime, minimal[i].burstTime);
+            }
+            printf("\n");
+            free(reports[e].minimal[kind]);
+        }
+    }
+
+    if (allMatched) printf("\nEvery engine matched the reference\n");
+    for (int c = 0; c < CASES_PER_BATCH; c++) {
+        free(expected[c].metrics);
+        free(expected[c].slices);
+    }
+    for (int r = 0; r < CASES_PER_BATCH * NUM_ENGINES; r++) {
+        free(actual[r].metrics);
+        free(actual[r].slices);
+    }
+    free(cases);
+    free(expected);
+    free(actual);
+    free(tasks);
+    return allMatched ? 0 : 1;
+}
+
+// Parse command-line options
+// Returns false if an option is invalid
+bool parseArguments(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        char *end;
+        if (strncmp(argv[i], "--cases=", 8) == 0) {
+            numCases = strtol(argv[i] + 8, &end, 10);
+            if (*end != '\0' || numCases < 1) {
+                fprintf(stderr, "Invalid number of cases: %s\n", argv[i] + 8);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, &end, 10);
+            if (*end != '\0') {
+                fprintf(stderr, "Invalid seed: %s\n", argv[i] + 7);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--max-procs=", 12) == 0) {
+            maxProcs = (int)strtol(argv[i] + 12, &end, 10);
+            if (*end != '\0' || maxProcs < 1 || maxProcs > 100000) {
+                fprintf(stderr, "Invalid number of processes: %s\n", argv[i] + 12);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--max-burst=", 12) == 0) {
+            maxBurst = (int)strtol(argv[i] + 12, &end, 10);
+            if (*end != '\0' || maxBurst < 1 || maxBurst > 1000000) {
+                fprintf(stderr, "Invalid burst limit: %s\n", argv[i] + 12);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--huge=", 7) == 0) {
+            hugePercent = (int)strtol(argv[i] + 7, &end, 10);
+            if (*end != '\0' || hugePercent < 0 || hugePercent > 100) {
+                fprintf(stderr, "Invalid percentage: %s\n", argv[i] + 7);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            numJobs = (int)strtol(argv[i] + 7, &end, 10);
+            if (*end != '\0' || numJobs < 1 || numJobs > 1024) {
+                fprintf(stderr, "Invalid number of jobs: %s\n", argv[i] + 7);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--timeout=", 10) == 0) {
+            timeoutMs = (int)strtol(argv[i] + 10, &end, 10);
+            if (*end != '\0' || timeoutMs < 1) {
+                fprintf(stderr, "Invalid timeout: %s\n", argv[i] + 10);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--lib-dir=", 10) == 0) {
+            libDir = argv[i] + 10;
+        } else if (strncmp(argv[i], "--engines=", 10) == 0) {
+            engineFilter = argv[i] + 10;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+
+    for (int e = 0; engineFilter != NULL && e < NUM_ENGINES; e++) {
+        if (listContains(engineFilter, engines[e].name)) return true;
+    }
+    if (engineFilter != NULL) {
+        fprintf(stderr, "No known engine in --engines=%s\n", engineFilter);
+        return false;
+    }
+    return true;
+}
+
+// Print the supported command-line options
+void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --cases=N          Random cases to run (default 1000)\n");
+    fprintf(stderr, "  --seed=S           RNG seed (default 1)\n");
+    fprintf(stderr, "  --max-procs=N      Largest case in processes (default 10)\n");
+    fprintf(stderr, "  --max-burst=B      Largest Burst Time (default 10)\n");
+    fprintf(stderr, "  --huge=P           Percent of cases moved to end at INT_MAX (default 5)\n");
+    fprintf(stderr, "  --jobs=N           Engines to run at a time (default: one per CPU)\n");
+    fprintf(stderr, "  --timeout=MS       Report a run taking over MS milliseconds as a hang (default 100)\n");
+    fprintf(stderr, "  --lib-dir=DIR      Where the engine libraries are (default .)\n");
+    fprintf(stderr, "  --engines=LIST     Engines to test (default all):");
+    for (int e = 0; e < NUM_ENGINES; e++) fprintf(stderr, "%s %s", e > 0 ? "," : "", engines[e].name);
+    fprintf(stderr, "\n");
+}
+
+// True if name is one of the comma-separated entries of list
+bool listContains(const char *list, const char *name) {
+    size_t length = strlen(name);
+    const char *p = list;
+    while (p != NULL && *p != '\0') {
+        const char *comma = strchr(p, ',');
+        size_t entry = comma != NULL ? (size_t)(comma - p) : strlen(p);
+        if (entry == length && strncmp(p, name, length) == 0) return true;
+        p = comma != NULL ? comma + 1 : NULL;
+    }
+    return false;
+}
+
+bool engineSelected(int engine) {
+    return engineFilter == NULL || listContains(engineFilter, engines[engine].name);
+}
+
+// Load the library of every selected engine and look up its main()
+// The libraries stay loaded until exit; RTLD_LOCAL keeps their globals apart
+bool loadEngines(void) {
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        if (!engineSelected(e)) continue;
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", libDir, engines[e].library);
+        void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (library == NULL) {
+            fprintf(stderr, "Error: cannot load %s: %s\n", path, dlerror());
+            fprintf(stderr, "Build it as shown under Terminal code at the top of difftest.c\n");
+            return false;
+        }
+        engineMain[e] = (int (*)(int, char **))dlsym(library, "main");
+        if (engineMain[e] == NULL) {
+            fprintf(stderr, "Error: %s has no main()\n", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Create the job slots and their scratch files
+bool openJobSlots(void) {
+    if (numJobs == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numJobs = cpus > 0 ? (int)cpus : 1;
+    }
+    slots = calloc((size_t)numJobs, sizeof(JobSlot));
+    if (slots == NULL) {
+        fprintf(stderr, "Error allocating memory for %d jobs\n", numJobs);
+        return false;
+    }
+    for (int s = 0; s < numJobs; s++) {
+        slots[s].input = tmpfile();
+        slots[s].output = tmpfile();
+        slots[s].gantt = tmpfile();
+        if (slots[s].input == NULL || slots[s].output == NULL || slots[s].gantt == NULL) {
+            fprintf(stderr, "Error: cannot create temporary files: %s\n", strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+// splitmix64: small, fast, and good enough to drive the case generator
+uint64_t rngNext(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Random case, in input (not arrival) order
+// Arrivals are spread over a random window, from everyone at once to
+// gaps long enough to leave the CPU idle, so ties and idle time both occur.
+// hugePercent of the cases are then pushed up against INT_MAX: every
+// arrival is delayed, or one Burst Time raised, by the time left between
+// the last completion and INT_MAX
+void generateCase(uint64_t *state, CaseProcess procs[], int *n) {
+    *n = 1 + (int)(rngNext(state) % (uint64_t)maxProcs);
+    int spread = 1 + (int)(rngNext(state) % (uint64_t)(*n * (maxBurst + 1) / 2 + 1));
+    for (int i = 0; i < *n; i++) {
+        procs[i].arrivalTime = (int)(rngNext(state) % (uint64_t)spread);
+        procs[i].burstTime = 1 + (int)(rngNext(state) % (uint64_t)maxBurst);
+    }
+    if ((int)(rngNext(state) % 100) >= hugePercent) return;
+
+    // Raising one Burst Time by d moves the last completion by at most d
+    outputReset(&expectedOutput, *n);
+    runReference(procs, *n, &expectedOutput);
+    int headroom = INT_MAX - expectedOutput.span;
+    if (rngNext(state) % 2 == 0) {
+        for (int i = 0; i < *n; i++) procs[i].arrivalTime += headroom;
+    } else {
+        procs[rngNext(state) % (uint64_t)*n].burstTime += headroom;
+    }
+}
+
+// True if the engine can run the case: few enough processes, and short
+// enough for an engine that steps or draws one time unit at a time
+bool engineAccepts(const Engine *engine, const CaseProcess procs[], int n, int span) {
+    long work = 0;
+    for (int i = 0; i < n; i++) work += procs[i].burstTime;
+    return n <= engine->maxProcs && span <= engine->maxSpan && work <= engine->maxWork;
+}
+
+// Clear out for a case of n processes
+void outputReset(RunOutput *out, int n) {
+    int *metrics = realloc(out->metrics, (size_t)(n > 0 ? n : 1) * NUM_METRICS * sizeof(int));
+    if (metrics == NULL) {
+        fprintf(stderr, "Error allocating memory for the results\n");
+        exit(1);
+    }
+    out->metrics = metrics;
+    for (int i = 0; i < n * NUM_METRICS; i++) out->metrics[i] = METRIC_NONE;
+    out->sliceCount = 0;
+    out->span = 0;
+    out->failure[0] = '\0';
+}
+
+// Record that pid ran from start to end
+// IDLE and empty slices are dropped, and a slice continuing the previous
+// one of the same process is merged into it
+void outputAddSlice(RunOutput *out, int pid, int start, int end) {
+    if (pid == 0 || end <= start) return;
+    if (out->sliceCount > 0) {
+        GanttEntry *last = &out->slices[out->sliceCount - 1];
+        if (last->pid == pid && last->endTime == start) {
+            last->endTime = end;
+            return;
+        }
+    }
+    if (out->sliceCount == out->sliceCapacity) {
+        int capacity = out->sliceCapacity > 0 ? 2 * out->sliceCapacity : 64;
+        GanttEntry *slices = realloc(out->slices, (size_t)capacity * sizeof(GanttEntry));
+        if (slices == NULL) {
+            fprintf(stderr, "Error allocating memory for the Gantt chart\n");
+            exit(1);
+        }
+        out->slices = slices;
+        out->sliceCapacity = capacity;
+    }
+    out->slices[out->sliceCount++] = (GanttEntry){pid, start, end};
+}
+
+// Record the results of a completed process
+void outputSetMetrics(RunOutput *out, int pid, int completion, int arrival, int burst, int start) {
+    int *metrics = &out->metrics[(pid - 1) * NUM_METRICS];
+    metrics[0] = completion - arrival;
+    metrics[1] = completion - arrival - burst;
+    metrics[2] = start - arrival;
+}
+
+// Copy from's busy slices into to with the idle time between them taken
+// out, which is all of the Gantt chart Shawn_STRF prints
+void outputCompact(const RunOutput *from, RunOutput *to) {
+    to->sliceCount = 0;
+    int busy = 0;
+    for (int s = 0; s < from->sliceCount; s++) {
+        int duration = from->slices[s].endTime - from->slices[s].startTime;
+        outputAddSlice(to, from->slices[s].pid, busy, busy + duration);
+        busy += duration;
+    }
+}
+
+// Run every task, numJobs at a time, each in a child of its own
+void runTasks(Task tasks[], int count) {
+    int next = 0, running = 0;
+    while (next < count || running > 0) {
+        if (next < count && running < numJobs) {
+            JobSlot *slot = slots;
+            while (slot->child != 0) slot++;
+            if (startTask(slot, &tasks[next++])) running++;
+            continue;
+        }
+
+        int status;
+        pid_t child = waitpid(-1, &status, 0);
+        if (child < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error waiting for an engine: %s\n", strerror(errno));
+            exit(1);
+        }
+        for (int s = 0; s < numJobs; s++) {
+            if (slots[s].child != child) continue;
+            finishTask(&slots[s], status);
+            slots[s].child = 0;
+            running--;
+            break;
+        }
+    }
+}
+
+// Fork a child to run the task in slot
+// Returns false (with the failure recorded) if it could not be started
+bool startTask(JobSlot *slot, const Task *task) {
+    slot->task = *task;
+    const Engine *engine = &engines[task->engine];
+    if (!writeCaseInput(slot->input, engine->input, task->procs, task->n) ||
+        ftruncate(fileno(slot->output), 0) != 0 || ftruncate(fileno(slot->gantt), 0) != 0) {
+        snprintf(task->out->failure, sizeof(task->out->failure), "could not be started (%s)", strerror(errno));
+        return false;
+    }
+    // The child shares the files' offsets, so they start at 0 for it too
+    rewind(slot->output);
+    rewind(slot->gantt);
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t child = fork();
+    if (child < 0) {
+        snprintf(task->out->failure, sizeof(task->out->failure), "could not be started (%s)", strerror(errno));
+        return false;
+    }
+    if (child == 0) runEngineChild(slot);
+    slot->child = child;
+    return true;
+}
+
+// In the forked child: run the engine's main() on the slot's files, and
+// exit with its status
+void runEngineChild(JobSlot *slot) {
+    int e = slot->task.engine;
+    char *args[MAX_ENGINE_ARGS + 2];
+    int count = 0;
+    args[count++] = (char *)engines[e].library;
+    for (int a = 0; engines[e].args[a] != NULL; a++) args[count++] = (char *)engines[e].args[a];
+    args[count] = NULL;
+
+    // Standard descriptors first, in case one of the files is descriptor 3
+    if (dup2(fileno(slot->input), STDIN_FILENO) < 0 || dup2(fileno(slot->output), STDOUT_FILENO) < 0 ||
+        dup2(fileno(slot->output), STDERR_FILENO) < 0 || dup2(fileno(slot->gantt), GANTT_FD) < 0) {
+        _exit(127);
+    }
+    // The timer's SIGALRM ends the child, engine threads and all
+    struct itimerval timer = {{0, 0}, {timeoutMs / 1000, (timeoutMs % 1000) * 1000}};
+    setitimer(ITIMER_REAL, &timer, NULL);
+    int status = engineMain[e](count, args);
+    fflush(NULL);
+    _exit(status);
+}
+
+// Record how the child of slot ended, and read back its results
+void finishTask(JobSlot *slot, int status) {
+    RunOutput *out = slot->task.out;
+    if (WIFSIGNALED(status)) {
+        if (WTERMSIG(status) == SIGALRM) {
+            snprintf(out->failure, sizeof(out->failure), "did not finish within %d ms", timeoutMs);
+        } else {
+            snprintf(out->failure, sizeof(out->failure), "crashed (%s)", strsignal(WTERMSIG(status)));
+        }
+        return;
+    }
+    if (WEXITSTATUS(status) != 0) {
+        snprintf(out->failure, sizeof(out->failure), "exited with status %d", WEXITSTATUS(status));
+        return;
+    }
+    parseOutput(slot);
+}
+
+// Write the case to file the way the engine reads it, and rewind it
+bool writeCaseInput(FILE *file, InputMode input, const CaseProcess procs[], int n) {
+    rewind(file);
+    if (ftruncate(fileno(file), 0) != 0) return false;
+    if (input == INPUT_TRACE) {
+        fprintf(file, "pid,arrival,burst\n");
+        for (int i = 0; i < n; i++) fprintf(file, "%d,%d,%d\n", i + 1, procs[i].arrivalTime, procs[i].burstTime);
+    } else {
+        fprintf(file, "%d\n", n);
+        for (int i = 0; i < n; i++) fprintf(file, "%d %d\n", procs[i].arrivalTime, procs[i].burstTime);
+    }
+    if (fflush(file) != 0) return false;
+    rewind(file);
+    return true;
+}
+
+// Read the results the engine of slot printed into its output
+// Anything missing is recorded as a failure
+void parseOutput(JobSlot *slot) {
+    RunOutput *out = slot->task.out;
+    OutputFormat format = engines[slot->task.engine].output;
+    int n = slot->task.n;
+    char *line = NULL, *labels = NULL, *markers = NULL;
+    size_t capacity = 0;
+    bool inGanttChart = false;
+    int busy = 0;
+
+    rewind(slot->output);
+    while (getline(&line, &capacity, slot->output) != -1) {
+        int pid, values[NUM_METRICS] = {METRIC_NONE, METRIC_NONE, METRIC_NONE}, ran, burst, left;
+        bool reported = false;
+        if (format == OUTPUT_SHAWN) {
+            if (sscanf(line, " process %d : executed %d/%d remaining %d", &pid, &ran, &burst, &left) == 4) {
+                // No start or end time is printed, so the slices are laid end to end
+                outputAddSlice(out, pid, busy, busy + ran);
+                busy += ran;
+            } else if (sscanf(line, "process %d: waiting time:%d turnaround time:%d", &pid, &values[1], &values[0]) == 3) {
+                reported = true;
+            }
+        } else if (sscanf(line, "Process P%d: Turnaround = %d, Waiting = %d, Response = %d",
+                          &pid, &values[0], &values[1], &values[2]) == 4) {
+            reported = true;
+        } else if (format == OUTPUT_ASCII && strcmp(line, "  Gantt Chart\n") == 0) {
+            inGanttChart = true;
+        } else if (inGanttChart && labels == NULL && line[0] == '|') {
+            labels = strdup(line);
+        } else if (labels != NULL && markers == NULL && line[0] >= '0' && line[0] <= '9') {
+            markers = strdup(line);
+        }
+
+        if (!reported) continue;
+        if (pid < 1 || pid > n) {
+            snprintf(out->failure, sizeof(out->failure), "printed results for P%d, which is not in the case", pid);
+            break;
+        }
+        memcpy(&out->metrics[(pid - 1) * NUM_METRICS], values, sizeof(values));
+    }
+
+    if (out->failure[0] == '\0') {
+        bool chart = format == OUTPUT_SHAWN ||
+                     (format == OUTPUT_ASCII ? labels != NULL && markers != NULL && parseAsciiGantt(labels, markers, out)
+                                             : parseJsonGantt(slot->gantt, out));
+        if (!chart) snprintf(out->failure, sizeof(out->failure), "printed no Gantt chart");
+    }
+    for (int pid = 1; pid <= n && out->failure[0] == '\0'; pid++) {
+        if (out->metrics[(pid - 1) * NUM_METRICS] == METRIC_NONE) {
+            snprintf(out->failure, sizeof(out->failure), "printed no results for P%d", pid);
+        }
+    }
+    free(line);
+    free(labels);
+    free(markers);
+}
+
+// Rebuild the slices of an ASCII Gantt chart (printGanttChart in TEMP.c):
+// a cell is 4 columns per time unit, less 3, plus its label, and the row of
+// times below starts with the start of the first cell
+// Returns false if the chart cannot be read
+bool parseAsciiGantt(const char *labels, const char *markers, RunOutput *out) {
+    char *end;
+    long time = strtol(markers, &end, 10);
+    if (end == markers) return false;
+
+    const char *cell = labels + 1, *bar;
+    while ((bar = strchr(cell, '|')) != NULL) {
+        const char *label = cell;
+        while (label < bar && *label == ' ') label++;
+        const char *labelEnd = label;
+        while (labelEnd < bar && *labelEnd != ' ') labelEnd++;
+
+        int pid;
+        if (labelEnd - label == 4 && strncmp(label, "IDLE", 4) == 0) {
+            pid = 0;
+        } else if (sscanf(label, "P%d", &pid) != 1) {
+            return false;
+        }
+        long duration = ((bar - cell) - (labelEnd - label) + 3) / 4;
+        outputAddSlice(out, pid, (int)time, (int)(time + duration));
+        time += duration;
+        cell = bar + 1;
+    }
+    return true;
+}
+
+// Read the slices of a Chrome trace-event Gantt chart (ganttExportChromeTrace in gantt_log.h)
+// Returns false if the engine did not write one
+bool parseJsonGantt(FILE *file, RunOutput *out) {
+    char *line = NULL;
+    size_t capacity = 0;
+    bool found = false;
+    rewind(file);
+    while (getline(&line, &capacity, file) != -1) {
+        int pid, lane, start, duration;
+        if (strncmp(line, "{\"traceEvents\":[", 16) == 0) found = true;
+        if (sscanf(line, "{\"name\":\"P%d\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%d,\"dur\":%d}",
+                   &pid, &lane, &start, &duration) == 4) {
+            outputAddSlice(out, pid, start, start + duration);
+        }
+    }
+    free(line);
+    return found;
+}
+
+// Compare an engine's output with the reference
+// Returns how they differ, with the first difference described in difference
+DifferenceKind compareOutputs(const RunOutput *expected, const RunOutput *actual, int n, const Engine *engine,
+                              char *difference, size_t size) {
+    if (actual->failure[0] != '\0') {
+        snprintf(difference, size, "%s %s", engine->name, actual->failure);
+        return DIFF_FAILURE;
+    }
+    for (int pid = 1; pid <= n; pid++) {
+        for (int m = 0; m < NUM_METRICS; m++) {
+            int want = expected->metrics[(pid - 1) * NUM_METRICS + m];
+            int got = actual->metrics[(pid - 1) * NUM_METRICS + m];
+            if (got != METRIC_NONE && got != want) {
+                snprintf(difference, size, "P%d %s Time: reference %d, %s %d", pid, metricNames[m], want,
+                         engine->name, got);
+                return DIFF_METRICS;
+            }
+        }
+    }
+
+    // Without times, only the order and length of the busy slices can be compared
+    const char *busyOnly = "";
+    if (engine->output == OUTPUT_SHAWN) {
+        outputCompact(expected, &compactOutput);
+        expected = &compactOutput;
+        busyOnly = " (busy time)";
+    }
+    for (int s = 0; s < expected->sliceCount || s < actual->sliceCount; s++) {
+        if (s >= actual->sliceCount) {
+            const GanttEntry *want = &expected->slices[s];
+            snprintf(difference, size, "Gantt slice %d%s: reference P%d %d-%d, %s has no more slices",
+                     s + 1, busyOnly, want->pid, want->startTime, want->endTime, engine->name);
+            return DIFF_GANTT;
+        }
+        if (s >= expected->sliceCount) {
+            const GanttEntry *got = &actual->slices[s];
+            snprintf(difference, size, "Gantt slice %d%s: reference has no more slices, %s P%d %d-%d",
+                     s + 1, busyOnly, engine->name, got->pid, got->startTime, got->endTime);
+            return DIFF_GANTT;
+        }
+        const GanttEntry *want = &expected->slices[s];
+        const GanttEntry *got = &actual->slices[s];
+        if (want->pid != got->pid || want->startTime != got->startTime || want->endTime != got->endTime) {
+            snprintf(difference, size, "Gantt slice %d%s: reference P%d %d-%d, %s P%d %d-%d", s + 1, busyOnly,
+                     want->pid, want->startTime, want->endTime, engine->name, got->pid, got->startTime, got->endTime);
+            return DIFF_GANTT;
+        }
+    }
+    return DIFF_NONE;
+}
+
+// Run a case through the reference and engine
+// Returns how their outputs differ (DIFF_NONE if the engine does not accept the case)
+DifferenceKind caseDiffers(int engine, const CaseProcess procs[], int n, char *difference, size_t size) {
+    outputReset(&expectedOutput, n);
+    runReference(procs, n, &expectedOutput);
+    if (!engineAccepts(&engines[engine], procs, n, expectedOutput.span)) return DIFF_NONE;
+    outputReset(&actualOutput, n);
+    Task task = {engine, procs, n, &expectedOutput, &actualOutput};
+    runTasks(&task, 1);
+    return compareOutputs(&expectedOutput, &actualOutput, n, &engines[engine], difference, size);
+}
+
+// Shrink a failing case in place: drop processes and lower Burst and
+// Arrival Times for as long as the engine keeps disagreeing in the same way
+// Returns the number of processes left
+int shrinkCase(int engine, CaseProcess procs[], int n, DifferenceKind kind) {
+    char difference[256];
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        // Remove one process at a time (later pids move down by one)
+        for (int i = 0; i < n && n > 1; i++) {
+            CaseProcess removed = procs[i];
+            memmove(&procs[i], &procs[i + 1], (size_t)(n - i - 1) * sizeof(CaseProcess));
+            if (caseDiffers(engine, procs, n - 1, difference, sizeof(difference)) == kind) {
+                n--;
+                i--;
+                changed = true;
+            } else {
+                memmove(&procs[i + 1], &procs[i], (size_t)(n - i - 1) * sizeof(CaseProcess));
+                procs[i] = removed;
+            }
+        }
+
+        // Fold one process into another, adding its Burst Time to the
+        // other's: the total work stays the same, so a case that only fails
+        // when the last completion is at INT_MAX still shrinks
+        for (int i = 0; i < n && n > 1; i++) {
+            for (int j = 0; j < n; j++) {
+                if (j == i || procs[j].burstTime > INT_MAX - procs[i].burstTime) continue;
+                CaseProcess removed = procs[i];
+                memmove(&procs[i], &procs[i + 1], (size_t)(n - i - 1) * sizeof(CaseProcess));
+                int into = j > i ? j - 1 : j;
+                procs[into].burstTime += removed.burstTime;
+                if (caseDiffers(engine, procs, n - 1, difference, sizeof(difference)) == kind) {
+                    n--;
+                    i = -1;
+                    changed = true;
+                    break;
+                }
+                procs[into].burstTime -= removed.burstTime;
+                memmove(&procs[i + 1], &procs[i], (size_t)(n - i - 1) * sizeof(CaseProcess));
+                procs[i] = removed;
+            }
+        }
+
+        // Lower each time to the smallest value that still fails, trying big steps first
+        for (int i = 0; i < n; i++) {
+            for (int field = 0; field < 2; field++) {
+                int *value = field == 0 ? &procs[i].burstTime : &procs[i].arrivalTime;
+                int lowest = field == 0 ? 1 : 0;
+                while (*value > lowest) {
+                    int original = *value;
+                    int candidates[3] = {lowest, lowest + (original - lowest) / 2, original - 1};
+                    bool lowered = false;
+                    for (int k = 0; k < 3 && !lowered; k++) {
+                        if (candidates[k] >= original) continue;
+                        *value = candidates[k];
+                        lowered = caseDiffers(engine, procs, n, difference, sizeof(difference)) == kind;
+                    }
+                    if (!lowered) {
+                        *value = original;
+                        break;
+                    }
+                    changed = true;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+// Textbook SRTF: the arrived process with the least Remaining Time runs;
+// ties go to the earliest arrival, then to input order. It runs until it
+// completes or the next process arrives, which is the schedule a choice
+// every time unit gives, since only the running process gets shorter
+void runReference(const CaseProcess procs[], int n, RunOutput *out) {
+    int *remaining = malloc((size_t)n * sizeof(int));
+    int *start = malloc((size_t)n * sizeof(int));
+    if (remaining == NULL || start == NULL) {
+        fprintf(stderr, "Error allocating memory for the reference run\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) {
+        remaining[i] = procs[i].burstTime;
+        start[i] = -1;
+    }
+
+    int time = 0, completed = 0;
+    while (completed < n) {
+        int best = -1, next = -1;
+        for (int i = 0; i < n; i++) {
+            if (remaining[i] == 0) continue;
+            if (procs[i].arrivalTime > time) {
+                if (next == -1 || procs[i].arrivalTime < procs[next].arrivalTime) next = i;
+            } else if (best == -1 || remaining[i] < remaining[best] ||
+                       (remaining[i] == remaining[best] && procs[i].arrivalTime < procs[best].arrivalTime)) {
+                best = i;
+            }
+        }
+        if (best == -1) {
+            // Idle until the next arrival
+            time = procs[next].arrivalTime;
+            continue;
+        }
+
+        int slice = remaining[best];
+        if (next != -1 && procs[next].arrivalTime - time < slice) slice = procs[next].arrivalTime - time;
+        if (start[best] == -1) start[best] = time;
+        outputAddSlice(out, best + 1, time, time + slice);
+        time += slice;
+        remaining[best] -= slice;
+        if (remaining[best] == 0) {
+            outputSetMetrics(out, best + 1, time, procs[best].arrivalTime, procs[best].burstTime, start[best]);
+            completed++;
+        }
+    }
+    out->span = time;
+    free(remaining);
+    free(start);
+}
@@ -0,0 +1,323 @@
+// Asynchronous event logger for the simulators' execution timeline.
+//
+// Logging threads never format or write anything themselves: eventLogAppend()
+// copies a fixed-size EventRecord into a ring buffer owned by the calling
+// thread (created on its first event), which takes a few nanoseconds and no
+// locks. A background writer thread drains every ring, puts the records back
+// in the order they were logged (each record carries a global sequence
+// number), and either formats them into a large text buffer that is written
+// out in batches, or dumps the raw records to a binary log file:
+//     EventLogHeader, then EventRecord[...] until the end of the file.
+//
+// A thread that publishes into an idle ring also pushes the ring onto the
+// log's pending list, so each writer pass only visits rings that have new
+// records, however many threads there are.
+// A ring that fills up makes its thread yield until the writer catches up,
+// so no event is ever dropped. Threads that log most of the events (the
+// scheduler, pool workers) should call eventLogRegisterThread() with a large
+// ring; one-event-per-slice threads get a small one so thousands of them stay
+// cheap.
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdalign.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define EVENT_RING_SMALL 64             // Records in a ring created on a thread's first event
+#define EVENT_RING_LARGE 16384          // Records in a ring for busy threads (see eventLogRegisterThread)
+#define EVENT_REORDER_WINDOW 8192       // Records the writer can hold back while reordering (power of two)
+#define EVENT_TEXT_BUFFER (1 << 16)     // Bytes of formatted text written at a time
+#define EVENT_LOG_MAGIC "SRTFLOG1"      // First 8 bytes of a binary event log
+#define EVENT_LOG_VERSION 1
+#define EVENT_LOG_IDLE_NS 200000        // Writer sleep when there is little to drain
+#define EVENT_LOG_BATCH 1024            // Records per pass that keep the writer from sleeping
+
+// One logged event; the meaning of type and the fields is up to the simulator
+typedef struct {
+    uint64_t seq;          // Global order in which events were logged
+    uint64_t thread;       // pthread_self() of the thread that ran the event
+    int32_t type;          // Event kind
+    int32_t time;          // Simulation time of the event
+    int32_t pid;           // Process the event is about
+    int32_t arg;           // Extra value (remaining time, end time, ...)
+} EventRecord;
+
+// Fixed-size header at the start of a binary event log
+typedef struct {
+    char magic[8];         // EVENT_LOG_MAGIC
+    uint32_t version;      // EVENT_LOG_VERSION
+    uint32_t recordSize;   // sizeof(EventRecord)
+} EventLogHeader;
+
+// Single-producer/single-consumer ring owned by one logging thread
+typedef struct EventRing {
+    alignas(64) atomic_size_t head;        // Next slot the writer reads
+    alignas(64) atomic_size_t tail;        // Next slot the owning thread writes
+    struct EventRing *next;                // Next ring registered with the log
+    struct EventRing *nextPending;         // Next ring on the pending list
+    atomic_bool pending;                   // Ring is on the pending list
+    size_t mask;                           // Capacity - 1 (capacity is a power of two)
+    EventRecord slots[];
+} EventRing;
+
+// Formats one record into buf, returning the number of bytes written
+typedef int (*EventFormatter)(const EventRecord *record, char *buf, size_t size);
+
+// Logger state shared by the logging threads and the writer thread
+typedef struct {
+    atomic_bool enabled;                   // Events are recorded only while set
+    atomic_bool stopping;                  // Writer drains everything and exits
+    atomic_uint_fast64_t nextSeq;          // Sequence number of the next event
+    _Atomic(EventRing *) rings;            // Every ring, newest first
+    _Atomic(EventRing *) pendingRings;     // Rings with records the writer has not seen
+    EventFormatter format;                 // Text formatter, NULL for binary output
+    FILE *out;                             // Text output or binary log file
+    bool ownsOut;                          // out was opened by eventLogStart
+    pthread_t writer;                      // Background writer thread
+    uint64_t written;                      // Records written so far (writer only)
+    EventRecord *window;                   // Reorder window indexed by seq (writer only)
+    bool *present;                         // window[i] holds a record (writer only)
+    char *text;                            // Formatting buffer (writer only)
+    size_t textLen;                        // Bytes pending in text (writer only)
+} EventLog;
+
+// Ring of the calling thread, created on its first event
+static _Thread_local EventRing *eventLogThreadRing = NULL;
+
+// Write out the pending formatted text
+static inline void eventLogFlushText(EventLog *log) {
+    if (log->textLen > 0) {
+        fwrite(log->text, 1, log->textLen, log->out);
+        log->textLen = 0;
+    }
+}
+
+// Write out one record, in sequence order
+static inline void eventLogEmit(EventLog *log, const EventRecord *record) {
+    if (log->format == NULL) {
+        fwrite(record, sizeof(EventRecord), 1, log->out);
+    } else {
+        // Format straight into the batch buffer, flushing it first if the
+        // record might not fit
+        if (EVENT_TEXT_BUFFER - log->textLen < 256) eventLogFlushText(log);
+        size_t space = EVENT_TEXT_BUFFER - log->textLen;
+        int len = log->format(record, log->text + log->textLen, space);
+        if (len > 0) log->textLen += (size_t)len < space ? (size_t)len : space - 1;
+    }
+    log->written++;
+}
+
+// Put a ring on the pending list unless it is already there
+static inline void eventLogMarkPending(EventLog *log, EventRing *ring) {
+    if (atomic_load(&ring->pending) || atomic_exchange(&ring->pending, true)) return;
+
+    ring->nextPending = atomic_load_explicit(&log->pendingRings, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&log->pendingRings, &ring->nextPending, ring,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+// Move records from the pending rings into the reorder window, then emit the
+// records that are next in sequence
+// Returns the number of records emitted
+static inline size_t eventLogDrain(EventLog *log) {
+    size_t emitted = 0;
+    EventRing *ring = atomic_exchange_explicit(&log->pendingRings, NULL, memory_order_acquire);
+
+    while (ring != NULL) {
+        EventRing *nextRing = ring->nextPending;
+
+        // Clear the flag before reading tail: a record published after this
+        // point either is seen below or puts the ring back on the list
+        atomic_store(&ring->pending, false);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        size_t tail = atomic_load(&ring->tail);
+
+        while (head != tail) {
+            const EventRecord *record = &ring->slots[head & ring->mask];
+            // A thread's records are in sequence order, so stop at the first
+            // one too far ahead of the window
+            if (record->seq - log->written >= EVENT_REORDER_WINDOW) break;
+            size_t slot = record->seq & (EVENT_REORDER_WINDOW - 1);
+            log->window[slot] = *record;
+            log->present[slot] = true;
+            head++;
+        }
+        atomic_store_explicit(&ring->head, head, memory_order_release);
+
+        // Records held back by the window are picked up on a later pass
+        if (head != tail) eventLogMarkPending(log, ring);
+        ring = nextRing;
+    }
+
+    // Emit the contiguous run starting at the next expected sequence number
+    size_t slot = log->written & (EVENT_REORDER_WINDOW - 1);
+    while (log->present[slot]) {
+        log->present[slot] = false;
+        eventLogEmit(log, &log->window[slot]);
+        emitted++;
+        slot = log->written & (EVENT_REORDER_WINDOW - 1);
+    }
+    return emitted;
+}
+
+// Writer thread: drains the rings until the log is stopped and every
+// logged event has been written
+static inline void *eventLogWriter(void *arg) {
+    EventLog *log = (EventLog *)arg;
+    struct timespec idle = {0, EVENT_LOG_IDLE_NS};
+
+    while (1) {
+        bool stopping = atomic_load_explicit(&log->stopping, memory_order_acquire);
+        size_t emitted = eventLogDrain(log);
+
+        // Let records pile up between passes rather than spin on a trickle,
+        // which would take CPU time from the threads doing the logging
+        if (emitted < EVENT_LOG_BATCH) {
+            if (stopping && log->written == atomic_load(&log->nextSeq)) break;
+            // Little new: write out what is buffered and wait for more
+            eventLogFlushText(log);
+            fflush(log->out);
+            nanosleep(&idle, NULL);
+        }
+    }
+    eventLogFlushText(log);
+    fflush(log->out);
+    return NULL;
+}
+
+// Start logging
+// With format set, records are formatted as text and written to out;
+// otherwise they are written in binary to the file at binaryPath
+// Returns 0 on success, -1 on error (after printing a message)
+static inline int eventLogStart(EventLog *log, EventFormatter format, FILE *out, const char *binaryPath) {
+    memset(log, 0, sizeof(*log));
+    log->format = format;
+    log->out = out;
+
+    if (format == NULL) {
+        log->out = fopen(binaryPath, "wb");
+        if (log->out == NULL) {
+            fprintf(stderr, "Error: cannot create event log '%s'\n", binaryPath);
+            return -1;
+        }
+        log->ownsOut = true;
+
+        EventLogHeader header;
+        memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic));
+        header.version = EVENT_LOG_VERSION;
+        header.recordSize = sizeof(EventRecord);
+        fwrite(&header, sizeof(header), 1, log->out);
+    }
+
+    log->window = malloc(EVENT_REORDER_WINDOW * sizeof(EventRecord));
+    log->present = calloc(EVENT_REORDER_WINDOW, sizeof(bool));
+    log->text = malloc(EVENT_TEXT_BUFFER);
+    if (log->window == NULL || log->present == NULL || log->text == NULL) {
+        fprintf(stderr, "Error allocating memory for the event log\n");
+        return -1;
+    }
+
+    atomic_init(&log->nextSeq, 0);
+    atomic_init(&log->rings, NULL);
+    atomic_init(&log->pendingRings, NULL);
+    atomic_init(&log->stopping, false);
+    atomic_init(&log->enabled, true);
+    if (pthread_create(&log->writer, NULL, eventLogWriter, log) != 0) {
+        fprintf(stderr, "Error: cannot start the event log writer\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Give the calling thread a ring of the given capacity (a power of two)
+// Returns the ring, or NULL if the log is not running or memory ran out
+static inline EventRing *eventLogRegisterThread(EventLog *log, size_t capacity) {
+    if (!atomic_load_explicit(&log->enabled, memory_order_relaxed)) return NULL;
+    if (eventLogThreadRing != NULL) return eventLogThreadRing;
+
+    EventRing *ring = aligned_alloc(64, (sizeof(EventRing) + capacity * sizeof(EventRecord) + 63) / 64 * 64);
+    if (ring == NULL) return NULL;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->pending, false);
+    ring->mask = capacity - 1;
+
+    // Push onto the writer's list of rings
+    ring->next = atomic_load_explicit(&log->rings, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&log->rings, &ring->next, ring,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+    eventLogThreadRing = ring;
+    return ring;
+}
+
+// Record one event in the calling thread's ring, attributed to thread
+// (a thread the caller handed the work to); it keeps its place in the
+// calling thread's order of events
+// Does nothing unless the log has been started
+static inline void eventLogAppendAs(EventLog *log, uint64_t thread, int type, int time, int pid, int arg) {
+    if (!atomic_load_explicit(&log->enabled, memory_order_relaxed)) return;
+
+    EventRing *ring = eventLogThreadRing;
+    if (ring == NULL) {
+        ring = eventLogRegisterThread(log, EVENT_RING_SMALL);
+        if (ring == NULL) return;
+    }
+
+    // Wait for space before taking a sequence number, so a sequence number
+    // is never held by a thread that cannot publish it
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) > ring->mask) {
+        sched_yield();
+    }
+
+    EventRecord *record = &ring->slots[tail & ring->mask];
+    record->seq = atomic_fetch_add_explicit(&log->nextSeq, 1, memory_order_relaxed);
+    record->thread = thread;
+    record->type = type;
+    record->time = time;
+    record->pid = pid;
+    record->arg = arg;
+    atomic_store(&ring->tail, tail + 1);
+    eventLogMarkPending(log, ring);
+}
+
+// Record one event from the calling thread
+// Does nothing unless the log has been started
+static inline void eventLogAppend(EventLog *log, int type, int time, int pid, int arg) {
+    eventLogAppendAs(log, (uint64_t)pthread_self(), type, time, pid, arg);
+}
+
+// Write out every logged event and stop the writer thread
+// Threads must have stopped logging; their rings are freed here
+static inline void eventLogStop(EventLog *log) {
+    if (!atomic_load(&log->enabled)) return;
+    atomic_store(&log->enabled, false);
+    atomic_store_explicit(&log->stopping, true, memory_order_release);
+    pthread_join(log->writer, NULL);
+
+    EventRing *ring = atomic_load(&log->rings);
+    while (ring != NULL) {
+        EventRing *next = ring->next;
+        free(ring);
+        ring = next;
+    }
+    atomic_store(&log->rings, NULL);
+    eventLogThreadRing = NULL;
+    if (log->ownsOut) fclose(log->out);
+    free(log->window);
+    free(log->present);
+    free(log->text);
+}
+
+#endif
@@ -0,0 +1,255 @@
+// Compressed Gantt log for the simulators' execution slices.
+//
+// A GanttLog is a time-ordered list of (pid, start, end) slices (pid 0 for
+// IDLE) stored as three columns of LEB128 varints:
+//     pid       the process ID
+//     gap       start - end of the previous slice (zigzag-encoded)
+//     duration  end - start
+// The slices of a schedule are contiguous, so the gap is nearly always 0 and
+// a slice takes about 3 bytes instead of the 12 of a GanttEntry.
+//
+// ganttAdd() coalesces a slice with the previous one when the same pid
+// continues without a gap, so callers can add every tick or slice as it runs.
+// The last slice is kept decoded until a different one arrives, since it may
+// still be extended. Readers walk the log with a GanttCursor, which decodes one
+// slice at a time, so printing or exporting a long chart never materialises
+// it in memory.
+//
+// Export formats:
+//     ganttExportBinary() writes the columns as they are:
+//         GanttFileHeader, then for each lane a GanttLaneHeader followed by
+//         its pid, gap and duration columns (pidBytes, gapBytes and
+//         durationBytes bytes).
+//     ganttExportChromeTrace() writes Chrome trace-event JSON (one "X"
+//     event per slice, one thread per lane, 1 time unit = 1 microsecond)
+//     for chrome://tracing, Perfetto or Speedscope.
+
+#ifndef GANTT_LOG_H
+#define GANTT_LOG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GANTT_COLUMN_INITIAL 4096      // Bytes first allocated for a column
+#define GANTT_FILE_MAGIC "SRTFGNT1"    // First 8 bytes of a binary Gantt file
+#define GANTT_FILE_VERSION 1
+
+// One execution slice
+typedef struct {
+    int pid;               // Process ID executing (0 = IDLE)
+    int startTime;         // Start time of this execution slice
+    int endTime;           // End time of this execution slice
+} GanttEntry;
+
+// Growable byte column of varints
+typedef struct {
+    unsigned char *data;
+    size_t size;           // Bytes used
+    size_t capacity;       // Bytes allocated
+} GanttColumn;
+
+// Append-only compressed Gantt log; zero-initialised means empty
+typedef struct {
+    GanttColumn pid;       // Process ID of each encoded slice
+    GanttColumn gap;       // Idle gap before each encoded slice
+    GanttColumn duration;  // Length of each encoded slice
+    int encodedEnd;        // End time of the last encoded slice
+    GanttEntry last;       // Most recent slice, not encoded yet
+    bool hasLast;          // last holds a slice
+    int size;              // Total number of slices, including last
+} GanttLog;
+
+// Reads the slices of a log in order
+typedef struct {
+    const GanttLog *log;
+    size_t pidPos;         // Next byte of each column
+    size_t gapPos;
+    size_t durationPos;
+    int end;               // End time of the previous slice
+    int remaining;         // Slices not returned yet
+} GanttCursor;
+
+// Fixed-size header at the start of a binary Gantt file
+typedef struct {
+    char magic[8];         // GANTT_FILE_MAGIC
+    uint32_t version;      // GANTT_FILE_VERSION
+    uint32_t lanes;        // Number of lanes (CPUs) that follow
+} GanttFileHeader;
+
+// Header of one lane in a binary Gantt file, followed by its three columns
+typedef struct {
+    uint64_t slices;       // Number of slices
+    uint64_t pidBytes;     // Bytes of the pid column
+    uint64_t gapBytes;     // Bytes of the gap column
+    uint64_t durationBytes;// Bytes of the duration column
+} GanttLaneHeader;
+
+static inline void ganttColumnPut(GanttColumn *column, uint32_t value) {
+    if (column->capacity - column->size < 5) {
+        size_t capacity = column->capacity > 0 ? column->capacity * 2 : GANTT_COLUMN_INITIAL;
+        unsigned char *data = realloc(column->data, capacity);
+        if (data == NULL) {
+            fprintf(stderr, "Error allocating memory for the Gantt chart\n");
+            exit(1);
+        }
+        column->data = data;
+        column->capacity = capacity;
+    }
+    while (value >= 0x80) {
+        column->data[column->size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    column->data[column->size++] = (unsigned char)value;
+}
+
+static inline uint32_t ganttColumnGet(const GanttColumn *column, size_t *pos) {
+    uint32_t value = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+        byte = column->data[(*pos)++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+// Move the pending slice into the columns
+static inline void ganttEncodeLast(GanttLog *log) {
+    if (!log->hasLast) return;
+    int gap = log->last.startTime - log->encodedEnd;
+    ganttColumnPut(&log->pid, (uint32_t)log->last.pid);
+    ganttColumnPut(&log->gap, ((uint32_t)gap << 1) ^ (uint32_t)(gap >> 31));
+    ganttColumnPut(&log->duration, (uint32_t)(log->last.endTime - log->last.startTime));
+    log->encodedEnd = log->last.endTime;
+    log->hasLast = false;
+}
+
+// Record that pid ran (or the CPU idled, pid 0) from start to end
+// Slices must be added in time order
+static inline void ganttAdd(GanttLog *log, int pid, int start, int end) {
+    if (log->hasLast && log->last.pid == pid && log->last.endTime == start) {
+        log->last.endTime = end;
+        return;
+    }
+    ganttEncodeLast(log);
+    log->last.pid = pid;
+    log->last.startTime = start;
+    log->last.endTime = end;
+    log->hasLast = true;
+    log->size++;
+}
+
+// Start time of the first slice, or 0 if the log is empty
+static inline int ganttFirstStart(const GanttLog *log) {
+    if (log->pid.size > 0) {
+        size_t pos = 0;
+        uint32_t gap = ganttColumnGet(&log->gap, &pos);
+        return (int)(gap >> 1) ^ -(int)(gap & 1);
+    }
+    return log->hasLast ? log->last.startTime : 0;
+}
+
+// Bytes allocated for the log
+static inline size_t ganttBytes(const GanttLog *log) {
+    return log->pid.capacity + log->gap.capacity + log->duration.capacity;
+}
+
+static inline void ganttFree(GanttLog *log) {
+    free(log->pid.data);
+    free(log->gap.data);
+    free(log->duration.data);
+    *log = (GanttLog){0};
+}
+
+static inline void ganttCursorInit(GanttCursor *cursor, const GanttLog *log) {
+    *cursor = (GanttCursor){log, 0, 0, 0, 0, log->size};
+}
+
+// Next slice of the log; returns false after the last one
+static inline bool ganttCursorNext(GanttCursor *cursor, GanttEntry *entry) {
+    const GanttLog *log = cursor->log;
+    if (cursor->remaining == 0) return false;
+    cursor->remaining--;
+
+    if (cursor->pidPos == log->pid.size) {
+        *entry = log->last;
+        return true;
+    }
+    uint32_t gap = ganttColumnGet(&log->gap, &cursor->gapPos);
+    entry->pid = (int)ganttColumnGet(&log->pid, &cursor->pidPos);
+    entry->startTime = cursor->end + ((int)(gap >> 1) ^ -(int)(gap & 1));
+    entry->endTime = entry->startTime + (int)ganttColumnGet(&log->duration, &cursor->durationPos);
+    cursor->end = entry->endTime;
+    return true;
+}
+
+// Write lanes[0..count-1] to path in the binary format above
+// The pending slice of each lane is encoded first
+// Returns 0 on success, -1 on error
+static inline int ganttExportBinary(const char *path, GanttLog *const lanes[], int count) {
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        fprintf(stderr, "Error: cannot create Gantt file '%s'\n", path);
+        return -1;
+    }
+
+    GanttFileHeader header = {GANTT_FILE_MAGIC, GANTT_FILE_VERSION, (uint32_t)count};
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    for (int l = 0; l < count && ok; l++) {
+        GanttLog *log = lanes[l];
+        ganttEncodeLast(log);
+        GanttLaneHeader lane = {(uint64_t)log->size, log->pid.size, log->gap.size, log->duration.size};
+        ok = fwrite(&lane, sizeof(lane), 1, out) == 1 &&
+             fwrite(log->pid.data, 1, log->pid.size, out) == log->pid.size &&
+             fwrite(log->gap.data, 1, log->gap.size, out) == log->gap.size &&
+             fwrite(log->duration.data, 1, log->duration.size, out) == log->duration.size;
+    }
+    if (fclose(out) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "Error writing Gantt file '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Write lanes[0..count-1] to path as Chrome trace-event JSON, lane l as
+// thread "CPU l"; IDLE slices are left out
+// Returns 0 on success, -1 on error
+static inline int ganttExportChromeTrace(const char *path, GanttLog *const lanes[], int count) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Error: cannot create trace file '%s'\n", path);
+        return -1;
+    }
+
+    fprintf(out, "{\"traceEvents\":[\n");
+    for (int l = 0; l < count; l++) {
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"CPU %d\"}}",
+                l > 0 ? ",\n" : "", l, l);
+    }
+
+    GanttCursor cursor;
+    GanttEntry entry;
+    for (int l = 0; l < count; l++) {
+        ganttCursorInit(&cursor, lanes[l]);
+        while (ganttCursorNext(&cursor, &entry)) {
+            if (entry.pid == 0) continue;
+            fprintf(out, ",\n{\"name\":\"P%d\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%d,\"dur\":%d}",
+                    entry.pid, l, entry.startTime, entry.endTime - entry.startTime);
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    bool failed = ferror(out) != 0;
+    if (fclose(out) != 0) failed = true;
+    if (failed) {
+        fprintf(stderr, "Error writing trace file '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+#endif
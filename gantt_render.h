@@ -0,0 +1,291 @@
+// Downsampled Gantt charts for long schedules (see gantt_log.h).
+//
+// The time span of the chart is cut into `width` equal buckets, one per
+// terminal column or SVG column, and every slice adds its overlap with each
+// bucket it covers. A single cursor pass per lane does this in
+// O(slices + width) time and O(width) memory, however long the run was.
+//
+// Each bucket keeps its busy (non-IDLE) time for the utilisation view and up
+// to GANTT_BUCKET_CANDIDATES (pid, time) candidates for the dominant-process
+// view. When more processes than that share a bucket, the candidates are
+// maintained like a weighted Misra-Gries summary: a process that holds the
+// bucket for more than 1/(GANTT_BUCKET_CANDIDATES+1) of its time is
+// guaranteed to stay, so the reported process is the one that ran the longest
+// whenever it stands out, and a heavy one otherwise.
+//
+// Terminal output prints one row per lane: a symbol per bucket for its
+// dominant process (with a legend) or a shade for its utilisation. SVG output
+// draws each run of buckets with the same dominant process as one rectangle,
+// coloured by pid and shaded by utilisation.
+
+#ifndef GANTT_RENDER_H
+#define GANTT_RENDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include "gantt_log.h"
+
+#define GANTT_BUCKET_CANDIDATES 4                // Processes tracked per bucket
+#define GANTT_SVG_ROW 24                         // Pixel height of an SVG lane
+#define GANTT_SVG_LABEL 60                       // Pixel width of the lane labels
+#define GANTT_MIXED (-1)                         // Busy bucket with no process standing out
+
+// Symbols for the dominant processes, in order of first appearance
+static const char ganttSymbols[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+#define GANTT_SYMBOL_COUNT ((int)sizeof(ganttSymbols) - 1)
+// Utilisation shades, from idle to fully busy
+static const char ganttShades[] = " .:-=+*#@";
+#define GANTT_SHADE_LEVELS ((int)sizeof(ganttShades) - 2)
+
+// Time spent in one column of the chart
+typedef struct {
+    int busy;                                    // Time units some process ran
+    int pid[GANTT_BUCKET_CANDIDATES];            // Candidate processes (0 = free slot)
+    int time[GANTT_BUCKET_CANDIDATES];           // Time credited to each candidate
+} GanttBucket;
+
+// Process symbols handed out while printing
+typedef struct {
+    int pids[GANTT_SYMBOL_COUNT];
+    int count;
+} GanttLegend;
+
+// End time of the last slice, or 0 if the log is empty
+static inline int ganttLastEnd(const GanttLog *log) {
+    return log->hasLast ? log->last.endTime : log->encodedEnd;
+}
+
+// Credit time units of pid to a bucket
+static inline void ganttBucketAdd(GanttBucket *bucket, int pid, int time) {
+    if (pid == 0) return;
+    bucket->busy += time;
+
+    int slot = -1;
+    for (int c = 0; c < GANTT_BUCKET_CANDIDATES; c++) {
+        if (bucket->pid[c] == pid) {
+            bucket->time[c] += time;
+            return;
+        }
+        if (bucket->pid[c] == 0 && slot < 0) slot = c;
+    }
+
+    // Full: every candidate and the newcomer lose the smallest weight
+    if (slot < 0) {
+        int least = time;
+        for (int c = 0; c < GANTT_BUCKET_CANDIDATES; c++) {
+            if (bucket->time[c] < least) least = bucket->time[c];
+        }
+        time -= least;
+        for (int c = 0; c < GANTT_BUCKET_CANDIDATES; c++) {
+            bucket->time[c] -= least;
+            if (bucket->time[c] == 0) {
+                bucket->pid[c] = 0;
+                if (slot < 0) slot = c;
+            }
+        }
+        if (time == 0 || slot < 0) return;
+    }
+    bucket->pid[slot] = pid;
+    bucket->time[slot] = time;
+}
+
+// Process that ran the longest in a bucket, 0 if it was mostly idle, or
+// GANTT_MIXED if it was busy but every candidate cancelled out
+static inline int ganttBucketDominant(const GanttBucket *bucket, int length) {
+    int best = 0, bestTime = 0;
+    for (int c = 0; c < GANTT_BUCKET_CANDIDATES; c++) {
+        if (bucket->pid[c] != 0 && bucket->time[c] > bestTime) {
+            best = bucket->pid[c];
+            bestTime = bucket->time[c];
+        }
+    }
+    if (2 * bucket->busy < length) return 0;
+    return best != 0 ? best : GANTT_MIXED;
+}
+
+// First time of bucket b when [start, end) is cut into width buckets
+static inline int ganttBucketStart(int start, int end, int width, int b) {
+    return start + (int)((long long)b * (end - start) / width);
+}
+
+// Time units covered by bucket b
+static inline int ganttBucketLength(int start, int end, int width, int b) {
+    return ganttBucketStart(start, end, width, b + 1) - ganttBucketStart(start, end, width, b);
+}
+
+// Spread the slices of log over buckets[0..width-1] covering [start, end)
+// One pass over the log; slices outside [start, end) are ignored
+static inline void ganttDownsample(const GanttLog *log, int start, int end, int width, GanttBucket buckets[]) {
+    GanttCursor cursor;
+    GanttEntry entry;
+    long long span = end - start;
+
+    for (int b = 0; b < width; b++) {
+        buckets[b] = (GanttBucket){0};
+    }
+    if (span <= 0) return;
+
+    ganttCursorInit(&cursor, log);
+    while (ganttCursorNext(&cursor, &entry)) {
+        int from = entry.startTime > start ? entry.startTime : start;
+        int to = entry.endTime < end ? entry.endTime : end;
+        if (from >= to) continue;
+
+        int b = (int)((from - start) * (long long)width / span);
+        while (from < to) {
+            int bucketEnd = ganttBucketStart(start, end, width, b + 1);
+            int piece = (to < bucketEnd ? to : bucketEnd) - from;
+            ganttBucketAdd(&buckets[b], entry.pid, piece);
+            from += piece;
+            b++;
+        }
+    }
+}
+
+// Symbol of a process, handing out the next free one on first use
+// '#' once every symbol is taken
+static inline char ganttLegendSymbol(GanttLegend *legend, int pid) {
+    for (int i = 0; i < legend->count; i++) {
+        if (legend->pids[i] == pid) return ganttSymbols[i];
+    }
+    if (legend->count == GANTT_SYMBOL_COUNT) return '#';
+    legend->pids[legend->count] = pid;
+    return ganttSymbols[legend->count++];
+}
+
+// Print lanes[0..count-1] as one row of width columns each
+// utilisation: shade each column by how busy the lane was, instead of
+// showing its dominant process
+// Returns false if the buckets cannot be allocated
+static inline bool ganttPrintCompact(FILE *out, GanttLog *const lanes[], int count, int width, bool utilisation) {
+    int start = INT_MAX, end = 0;
+    for (int l = 0; l < count; l++) {
+        if (lanes[l]->size == 0) continue;
+        int first = ganttFirstStart(lanes[l]);
+        if (first < start) start = first;
+        if (ganttLastEnd(lanes[l]) > end) end = ganttLastEnd(lanes[l]);
+    }
+    if (start >= end) return true;
+    if (width > end - start) width = end - start;
+
+    GanttBucket *buckets = malloc((size_t)width * sizeof(GanttBucket));
+    if (buckets == NULL) return false;
+    GanttLegend legend = {{0}, 0};
+    bool other = false;
+
+    fprintf(out, "%d-%d, %.2f time units per column; %s\n\n", start, end,
+            (double)(end - start) / width,
+            utilisation ? "shade = share of the column busy (' ' idle .. '@' busy)"
+                        : "symbol = process that ran the longest ('.' mostly idle)");
+    for (int l = 0; l < count; l++) {
+        ganttDownsample(lanes[l], start, end, width, buckets);
+        if (count > 1) {
+            fprintf(out, "CPU %-3d |", l);
+        } else {
+            fprintf(out, "|");
+        }
+        for (int b = 0; b < width; b++) {
+            int length = ganttBucketLength(start, end, width, b);
+            if (utilisation) {
+                fputc(ganttShades[(int)((long long)buckets[b].busy * GANTT_SHADE_LEVELS / length)], out);
+            } else {
+                int pid = ganttBucketDominant(&buckets[b], length);
+                char symbol = pid == 0 ? '.' : pid == GANTT_MIXED ? '#' : ganttLegendSymbol(&legend, pid);
+                if (symbol == '#') other = true;
+                fputc(symbol, out);
+            }
+        }
+        fprintf(out, "|\n");
+    }
+
+    // Time axis: start under the first column, end under the last
+    fprintf(out, "%s%-*d%*d\n", count > 1 ? "         " : " ", width / 2, start, width - width / 2, end);
+
+    if (!utilisation && legend.count > 0) {
+        fprintf(out, "\nLegend:");
+        for (int i = 0; i < legend.count; i++) {
+            fprintf(out, "%s%c=P%d", i % 10 == 0 ? "\n  " : "  ", ganttSymbols[i], legend.pids[i]);
+        }
+        fprintf(out, "%s\n", other ? "\n  #=other or mixed processes" : "");
+    }
+    free(buckets);
+    return true;
+}
+
+// Write lanes[0..count-1] to path as an SVG chart width buckets wide
+// Returns 0 on success, -1 on error
+static inline int ganttWriteSvg(const char *path, GanttLog *const lanes[], int count, int width) {
+    int start = INT_MAX, end = 0;
+    for (int l = 0; l < count; l++) {
+        if (lanes[l]->size == 0) continue;
+        int first = ganttFirstStart(lanes[l]);
+        if (first < start) start = first;
+        if (ganttLastEnd(lanes[l]) > end) end = ganttLastEnd(lanes[l]);
+    }
+    if (start >= end) start = end = 0;
+    if (width > end - start) width = end - start > 0 ? end - start : 1;
+
+    FILE *out = fopen(path, "w");
+    GanttBucket *buckets = malloc((size_t)width * sizeof(GanttBucket));
+    if (out == NULL || buckets == NULL) {
+        fprintf(stderr, "Error: cannot create SVG file '%s'\n", path);
+        if (out != NULL) fclose(out);
+        free(buckets);
+        return -1;
+    }
+
+    int height = count * GANTT_SVG_ROW + 30;
+    fprintf(out, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" "
+                 "font-family=\"monospace\" font-size=\"12\">\n", GANTT_SVG_LABEL + width + 10, height);
+    for (int l = 0; l < count; l++) {
+        int y = l * GANTT_SVG_ROW + 4;
+        fprintf(out, "<text x=\"4\" y=\"%d\">CPU %d</text>\n", y + 15, l);
+        ganttDownsample(lanes[l], start, end, width, buckets);
+
+        // One rectangle per run of columns with the same dominant process
+        int runStart = 0;
+        int runPid = ganttBucketDominant(&buckets[0], ganttBucketLength(start, end, width, 0));
+        long long runBusy = 0;
+        for (int b = 0; b <= width; b++) {
+            int pid = b < width ? ganttBucketDominant(&buckets[b], ganttBucketLength(start, end, width, b)) : INT_MIN;
+            if (pid != runPid) {
+                int from = ganttBucketStart(start, end, width, runStart);
+                int to = ganttBucketStart(start, end, width, b);
+                double opacity = 0.3 + 0.7 * (double)runBusy / (to - from);
+                if (runPid == GANTT_MIXED) {
+                    fprintf(out, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" "
+                                 "fill=\"#888\" fill-opacity=\"%.2f\"><title>mixed %d-%d</title></rect>\n",
+                            GANTT_SVG_LABEL + runStart, y, b - runStart, GANTT_SVG_ROW - 4, opacity, from, to);
+                } else if (runPid != 0) {
+                    fprintf(out, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" "
+                                 "fill=\"hsl(%u,65%%,55%%)\" fill-opacity=\"%.2f\">"
+                                 "<title>P%d %d-%d</title></rect>\n",
+                            GANTT_SVG_LABEL + runStart, y, b - runStart, GANTT_SVG_ROW - 4,
+                            (unsigned)runPid * 137u % 360u, opacity, runPid, from, to);
+                }
+                runStart = b;
+                runPid = pid;
+                runBusy = 0;
+            }
+            if (b < width) runBusy += buckets[b].busy;
+        }
+    }
+    int axis = count * GANTT_SVG_ROW + 20;
+    fprintf(out, "<text x=\"%d\" y=\"%d\">%d</text>\n", GANTT_SVG_LABEL, axis, start);
+    fprintf(out, "<text x=\"%d\" y=\"%d\" text-anchor=\"end\">%d</text>\n", GANTT_SVG_LABEL + width, axis, end);
+    fprintf(out, "</svg>\n");
+    free(buckets);
+
+    bool failed = ferror(out) != 0;
+    if (fclose(out) != 0) failed = true;
+    if (failed) {
+        fprintf(stderr, "Error writing SVG file '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,225 @@
+// Stress test for STRF.c's lock-free handoff (--handoff=lockfree).
+//
+// Generates random workloads and runs each one through the STRF binary
+// twice: once with the mutex handoff and once through the lock-free rings.
+// Both runs must print the same per-process results and averages and write
+// the same Gantt chart (--gantt-json). The mutex runs alternate between one
+// thread per process and a pool of as many workers as the lock-free run
+// uses, and the runs alternate between tick and event-driven mode; every
+// fourth workload is streamed (--stream), where the scheduler retires
+// processes while workers are still running them.
+//
+// Each run is a separate process fed the workload on stdin (--trace=-),
+// so a crash or a hang (--timeout) fails only that run.
+// Exit status: 0 if every run matched.
+//
+// Terminal code:
+// gcc -O2 -pthread STRF.c -o STRF
+// gcc -O2 handoff_stress.c -o handoff_stress
+// ./handoff_stress --runs=1000 --strf=./STRF
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#define MAX_RUN_ARGS 8
+#define MAX_PROCESSES 200    // Largest generated workload
+#define MAX_OUTPUT (1 << 24)    // Larger outputs are reported as a failure
+
+// What one STRF run printed
+typedef struct {
+    char *results;         // Standard output up to the Simulation Speed report
+    size_t resultsSize;
+    char *gantt;           // --gantt-json output
+    size_t ganttSize;
+} RunOutput;
+
+// Read all of fd from the start into a malloc'd buffer
+// Returns NULL if it cannot be read or is larger than MAX_OUTPUT
+char *readAll(int fd, size_t *size) {
+    off_t length = lseek(fd, 0, SEEK_END);
+    if (length < 0 || length > MAX_OUTPUT || lseek(fd, 0, SEEK_SET) != 0) return NULL;
+    char *buffer = malloc((size_t)length + 1);
+    if (buffer == NULL) return NULL;
+    size_t done = 0;
+    while (done < (size_t)length) {
+        ssize_t got = read(fd, buffer + done, (size_t)length - done);
+        if (got <= 0) {
+            free(buffer);
+            return NULL;
+        }
+        done += (size_t)got;
+    }
+    buffer[done] = '\0';
+    *size = done;
+    return buffer;
+}
+
+// Run strf with args, the workload on stdin, stdout and descriptor 3
+// captured into output; the wall-clock speed report is cut off since it
+// differs between any two runs
+// Returns false (and says why) if STRF crashed, hung or failed
+bool runStrf(const char *strf, const char *args[], int input, int timeout, RunOutput *output) {
+    FILE *outFile = tmpfile();
+    FILE *ganttFile = tmpfile();
+    if (outFile == NULL || ganttFile == NULL) {
+        fprintf(stderr, "Error creating temporary files\n");
+        exit(1);
+    }
+    lseek(input, 0, SEEK_SET);
+
+    pid_t child = fork();
+    if (child < 0) {
+        fprintf(stderr, "Error starting %s\n", strf);
+        exit(1);
+    }
+    if (child == 0) {
+        dup2(input, 0);
+        dup2(fileno(outFile), 1);
+        dup2(fileno(ganttFile), 3);
+        // The alarm survives exec, so a hung run is killed by SIGALRM
+        alarm((unsigned)timeout);
+        execv(strf, (char *const *)args);
+        _exit(127);
+    }
+
+    int status;
+    waitpid(child, &status, 0);
+    bool ok = false;
+    if (WIFSIGNALED(status)) {
+        printf("  %s\n", WTERMSIG(status) == SIGALRM ? "hung" : strsignal(WTERMSIG(status)));
+    } else if (WEXITSTATUS(status) == 127) {
+        fprintf(stderr, "Error running %s\n", strf);
+        exit(1);
+    } else if (WEXITSTATUS(status) != 0) {
+        printf("  exit status %d\n", WEXITSTATUS(status));
+    } else {
+        output->results = readAll(fileno(outFile), &output->resultsSize);
+        output->gantt = readAll(fileno(ganttFile), &output->ganttSize);
+        ok = output->results != NULL && output->gantt != NULL;
+        if (ok) {
+            char *speed = strstr(output->results, "  Simulation Speed");
+            if (speed != NULL) output->resultsSize = (size_t)(speed - output->results);
+        } else {
+            printf("  output could not be read\n");
+        }
+    }
+    fclose(outFile);
+    fclose(ganttFile);
+    return ok;
+}
+
+int compareInts(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+void freeOutput(RunOutput *output) {
+    free(output->results);
+    free(output->gantt);
+}
+
+int main(int argc, char *argv[]) {
+    int runs = 1000;
+    unsigned int seed = 20240501;
+    const char *strf = "./STRF";
+    int lockFreeWorkers = 0;
+    int timeout = 10;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--runs=", 7) == 0) {
+            runs = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = (unsigned int)strtoul(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "--strf=", 7) == 0) {
+            strf = argv[i] + 7;
+        } else if (strncmp(argv[i], "--workers=", 10) == 0) {
+            lockFreeWorkers = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--timeout=", 10) == 0) {
+            timeout = atoi(argv[i] + 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--runs=N] [--seed=S] [--strf=PATH] [--workers=K] [--timeout=SECONDS]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (runs < 1 || timeout < 1 || lockFreeWorkers < 0) {
+        fprintf(stderr, "Invalid option value\n");
+        return 1;
+    }
+
+    // At least two lock-free workers, so slices really are pipelined across threads
+    if (lockFreeWorkers == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        lockFreeWorkers = cores > 1 ? (int)cores : 2;
+    }
+    char workersOption[32];
+    snprintf(workersOption, sizeof(workersOption), "--workers=%d", lockFreeWorkers);
+
+    printf("Handoff stress test: %d runs of %s\n", runs, strf);
+    int failures = 0;
+    for (int run = 0; run < runs && failures == 0; run++) {
+        int n = 1 + rand_r(&seed) % MAX_PROCESSES;
+        int spread = 1 + rand_r(&seed) % (4 * n);
+        bool eventDriven = run % 2 == 1;
+        bool pool = (run / 2) % 2 == 1;
+        bool streamed = run % 4 == 3;
+
+        // The workload as a trace file
+        FILE *trace = tmpfile();
+        if (trace == NULL) {
+            fprintf(stderr, "Error creating temporary files\n");
+            return 1;
+        }
+        int arrivals[MAX_PROCESSES];
+        for (int i = 0; i < n; i++) arrivals[i] = rand_r(&seed) % spread;
+        // A stream must arrive in order
+        if (streamed) qsort(arrivals, (size_t)n, sizeof(int), compareInts);
+        for (int i = 0; i < n; i++) {
+            fprintf(trace, "%d %d %d\n", i + 1, arrivals[i], 1 + rand_r(&seed) % 10);
+        }
+        fflush(trace);
+
+        const char *mutexArgs[MAX_RUN_ARGS], *lockFreeArgs[MAX_RUN_ARGS];
+        int m = 0, l = 0;
+        mutexArgs[m++] = lockFreeArgs[l++] = strf;
+        mutexArgs[m++] = lockFreeArgs[l++] = "--quiet";
+        mutexArgs[m++] = lockFreeArgs[l++] = "--gantt-json=/dev/fd/3";
+        mutexArgs[m++] = lockFreeArgs[l++] = "--trace=-";
+        if (eventDriven) mutexArgs[m++] = lockFreeArgs[l++] = "--event-driven";
+        if (streamed) mutexArgs[m++] = lockFreeArgs[l++] = "--stream";
+        if (pool || streamed) mutexArgs[m++] = workersOption;
+        lockFreeArgs[l++] = "--handoff=lockfree";
+        lockFreeArgs[l++] = workersOption;
+        mutexArgs[m] = lockFreeArgs[l] = NULL;
+
+        RunOutput expected = {0}, actual = {0};
+        const char *mode = streamed ? "streamed" : eventDriven ? "event-driven" : "tick";
+        if (!runStrf(strf, mutexArgs, fileno(trace), timeout, &expected)) {
+            printf("Run %d (%d processes, %s mode): mutex run failed\n", run + 1, n, mode);
+            failures++;
+        } else if (!runStrf(strf, lockFreeArgs, fileno(trace), timeout, &actual)) {
+            printf("Run %d (%d processes, %s mode): lock-free run failed\n", run + 1, n, mode);
+            failures++;
+        } else if (expected.resultsSize != actual.resultsSize || expected.ganttSize != actual.ganttSize ||
+                   memcmp(expected.results, actual.results, expected.resultsSize) != 0 ||
+                   memcmp(expected.gantt, actual.gantt, expected.ganttSize) != 0) {
+            printf("Run %d (%d processes, %s mode): lock-free results differ from mutex results\n",
+                   run + 1, n, mode);
+            failures++;
+        }
+        freeOutput(&expected);
+        freeOutput(&actual);
+        fclose(trace);
+    }
+
+    if (failures == 0) {
+        printf("All %d runs matched\n", runs);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+// Hot-path instrumentation for the simulators' scheduling loops: event
+// counters and mutex/condition-variable timers, printed as a table at the
+// end of a run.
+//
+// Everything here is compiled out unless the program is built with
+// -DSRTF_INSTRUMENT: the counting calls become empty inline functions and
+// instrMutexLock/instrMutexUnlock/instrCondWait call pthreads directly,
+// so a normal build has no extra loads, stores or timer reads.
+//
+// When enabled, each thread counts into its own InstrThread block (no atomics
+// on the hot path). Blocks start on a cache line and are padded to whole
+// lines, so no two threads share one; each is allocated on the thread's
+// first event and pushed onto a global list that instrPrintSummary() sums
+// once every thread has been joined. Times are read with rdtsc on x86,
+// converted to nanoseconds with a rate measured against CLOCK_MONOTONIC
+// over the run, and with clock_gettime elsewhere.
+//
+// Timers of the scheduler mutex:
+//     wait   from calling lock until it is acquired
+//     hold   from acquiring it until unlock, or until a condition wait
+//            releases it (the time blocked in the wait is not hold time)
+//     cond   time inside pthread_cond_wait, including reacquiring the mutex
+// Means are per interval: a wait reacquiring the mutex starts a new hold.
+
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+// Event counters
+typedef enum {
+    INSTR_DECISIONS,           // Scheduling decisions (slices dispatched)
+    INSTR_PREEMPTIONS,         // Running process put back for a better candidate
+    INSTR_IDLE_JUMPS,          // Clock advanced over an idle gap to the next arrival
+    INSTR_COND_WAITS,          // pthread_cond_wait calls
+    INSTR_SPURIOUS_WAKEUPS,    // Wakeups that found nothing to do
+    INSTR_LOCKS,               // Scheduler mutex acquisitions
+    INSTR_NUM_COUNTERS
+} InstrCounter;
+
+// Timers
+typedef enum {
+    INSTR_LOCK_WAIT,
+    INSTR_LOCK_HOLD,
+    INSTR_COND_WAIT,
+    INSTR_NUM_TIMERS
+} InstrTimer;
+
+// Kinds of thread, one column each in the summary
+typedef enum {
+    INSTR_ROLE_SCHEDULER,
+    INSTR_ROLE_PROCESS,        // One thread per process
+    INSTR_ROLE_WORKER,         // Pool or lock-free worker
+    INSTR_NUM_ROLES
+} InstrRole;
+
+#ifdef SRTF_INSTRUMENT
+
+#include <string.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+
+#define INSTR_CACHE_LINE 64
+
+// Counters of one thread
+typedef struct InstrThread {
+    alignas(INSTR_CACHE_LINE) uint64_t counts[INSTR_NUM_COUNTERS];
+    uint64_t ticks[INSTR_NUM_TIMERS];      // Total time of each timer
+    uint64_t intervals[INSTR_NUM_TIMERS];  // Intervals timed
+    uint64_t maxTicks[INSTR_NUM_TIMERS];   // Longest single interval
+    uint64_t holdStart;                    // When this thread acquired the mutex
+    InstrRole role;
+    struct InstrThread *next;              // Next block in instrThreads
+} InstrThread;
+
+static _Atomic(InstrThread *) instrThreads = NULL;    // Every thread's block
+static _Thread_local InstrThread *instrSelf = NULL;   // This thread's block
+static uint64_t instrStartTicks;                      // instrStart() reading of both clocks
+static uint64_t instrStartNs;
+
+static inline uint64_t instrClockNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static inline uint64_t instrNow(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return instrClockNs();
+#endif
+}
+
+// This thread's block, created on first use
+static inline InstrThread *instrThread(void) {
+    if (instrSelf == NULL) {
+        void *storage;
+        if (posix_memalign(&storage, INSTR_CACHE_LINE, sizeof(InstrThread)) != 0) {
+            fprintf(stderr, "Error allocating instrumentation counters\n");
+            exit(1);
+        }
+        InstrThread *block = memset(storage, 0, sizeof(InstrThread));
+        block->next = atomic_load_explicit(&instrThreads, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&instrThreads, &block->next, block,
+                                                      memory_order_release, memory_order_relaxed));
+        instrSelf = block;
+    }
+    return instrSelf;
+}
+
+// Call at the top of a thread function to label its column in the summary
+static inline void instrThreadStart(InstrRole role) {
+    instrThread()->role = role;
+}
+
+// Call once before the first simulated thread starts
+static inline void instrStart(void) {
+    instrStartTicks = instrNow();
+    instrStartNs = instrClockNs();
+}
+
+static inline void instrCount(InstrCounter counter) {
+    instrThread()->counts[counter]++;
+}
+
+static inline void instrAddTime(InstrThread *self, InstrTimer timer, uint64_t ticks) {
+    self->ticks[timer] += ticks;
+    self->intervals[timer]++;
+    if (ticks > self->maxTicks[timer]) self->maxTicks[timer] = ticks;
+}
+
+static inline void instrMutexLock(pthread_mutex_t *mutex) {
+    InstrThread *self = instrThread();
+    uint64_t start = instrNow();
+    pthread_mutex_lock(mutex);
+    self->holdStart = instrNow();
+    self->counts[INSTR_LOCKS]++;
+    instrAddTime(self, INSTR_LOCK_WAIT, self->holdStart - start);
+}
+
+static inline void instrMutexUnlock(pthread_mutex_t *mutex) {
+    InstrThread *self = instrThread();
+    instrAddTime(self, INSTR_LOCK_HOLD, instrNow() - self->holdStart);
+    pthread_mutex_unlock(mutex);
+}
+
+static inline void instrCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+    InstrThread *self = instrThread();
+    uint64_t start = instrNow();
+    instrAddTime(self, INSTR_LOCK_HOLD, start - self->holdStart);
+    self->counts[INSTR_COND_WAITS]++;
+    pthread_cond_wait(cond, mutex);
+    self->holdStart = instrNow();
+    instrAddTime(self, INSTR_COND_WAIT, self->holdStart - start);
+}
+
+// Print the counters summed per kind of thread, and the timers
+// Call after every instrumented thread has been joined
+static inline void instrPrintSummary(void) {
+    static const char *counterNames[INSTR_NUM_COUNTERS] = {
+        "Scheduling decisions", "Preemptions", "Idle jumps",
+        "Condvar waits", "Spurious wakeups", "Mutex acquisitions"};
+    static const char *timerNames[INSTR_NUM_TIMERS] = {"Mutex wait", "Mutex hold", "Condvar wait"};
+    static const char *roleNames[INSTR_NUM_ROLES] = {"Scheduler", "Process", "Worker"};
+
+    uint64_t counts[INSTR_NUM_ROLES][INSTR_NUM_COUNTERS] = {{0}};
+    uint64_t ticks[INSTR_NUM_TIMERS] = {0}, intervals[INSTR_NUM_TIMERS] = {0}, maxTicks[INSTR_NUM_TIMERS] = {0};
+    int threads[INSTR_NUM_ROLES] = {0};
+    for (InstrThread *block = atomic_load(&instrThreads); block != NULL; block = block->next) {
+        threads[block->role]++;
+        for (int c = 0; c < INSTR_NUM_COUNTERS; c++) counts[block->role][c] += block->counts[c];
+        for (int t = 0; t < INSTR_NUM_TIMERS; t++) {
+            ticks[t] += block->ticks[t];
+            intervals[t] += block->intervals[t];
+            if (block->maxTicks[t] > maxTicks[t]) maxTicks[t] = block->maxTicks[t];
+        }
+    }
+
+    // Timer ticks per nanosecond over the run (1 with clock_gettime)
+    double ticksPerNs = 1.0;
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t elapsedNs = instrClockNs() - instrStartNs;
+    if (elapsedNs > 0) ticksPerNs = (double)(instrNow() - instrStartTicks) / (double)elapsedNs;
+    if (!(ticksPerNs > 0)) ticksPerNs = 1.0;
+    const char *source = "rdtsc";
+#else
+    const char *source = "clock_gettime";
+#endif
+
+    printf("\n======================================\n");
+    printf("  Instrumentation\n");
+    printf("======================================\n\n");
+    printf("%-22s", "Counter");
+    for (int r = 0; r < INSTR_NUM_ROLES; r++) printf(" %12s", roleNames[r]);
+    printf(" %12s\n", "Total");
+    printf("%-22s", "Threads");
+    int totalThreads = 0;
+    for (int r = 0; r < INSTR_NUM_ROLES; r++) {
+        printf(" %12d", threads[r]);
+        totalThreads += threads[r];
+    }
+    printf(" %12d\n", totalThreads);
+    for (int c = 0; c < INSTR_NUM_COUNTERS; c++) {
+        uint64_t total = 0;
+        printf("%-22s", counterNames[c]);
+        for (int r = 0; r < INSTR_NUM_ROLES; r++) {
+            printf(" %12llu", (unsigned long long)counts[r][c]);
+            total += counts[r][c];
+        }
+        printf(" %12llu\n", (unsigned long long)total);
+    }
+
+    printf("\n%-22s %12s %12s %12s\n", "Timer", "Total (ms)", "Mean (ns)", "Max (ns)");
+    for (int t = 0; t < INSTR_NUM_TIMERS; t++) {
+        double totalNs = (double)ticks[t] / ticksPerNs;
+        printf("%-22s %12.3f %12.0f %12.0f\n", timerNames[t], totalNs / 1e6,
+               intervals[t] > 0 ? totalNs / (double)intervals[t] : 0.0, (double)maxTicks[t] / ticksPerNs);
+    }
+    printf("Timer source         = %s (%.3f ticks/ns); totals are summed over threads\n", source, ticksPerNs);
+
+    InstrThread *block = atomic_exchange(&instrThreads, NULL);
+    while (block != NULL) {
+        InstrThread *next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+#else
+
+static inline void instrThreadStart(InstrRole role) { (void)role; }
+static inline void instrStart(void) {}
+static inline void instrCount(InstrCounter counter) { (void)counter; }
+static inline void instrMutexLock(pthread_mutex_t *mutex) { pthread_mutex_lock(mutex); }
+static inline void instrMutexUnlock(pthread_mutex_t *mutex) { pthread_mutex_unlock(mutex); }
+static inline void instrCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex) { pthread_cond_wait(cond, mutex); }
+static inline void instrPrintSummary(void) {}
+
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+// Constant-memory summary statistics for per-process metrics (turnaround,
+// waiting and response time), updated as each process completes.
+//
+// OnlineStats keeps the count, exact sum (for the mean), Welford's running
+// variance, min/max and a log-linear histogram for percentiles, in the style
+// of an HDR histogram: values below 2^(STATS_SUB_BITS+1) have their own
+// bucket, and every power of two above that is split into 2^STATS_SUB_BITS
+// equal buckets. A reported percentile is the midpoint of its bucket, within
+// 1/2^(STATS_SUB_BITS+1) (under 1%) of the exact value, for any int up to
+// INT_MAX. The whole accumulator is a fixed ~13 KB however many samples it
+// sees, and two accumulators merge exactly (counts add up, variances combine
+// with Chan et al.'s formula), so per-thread copies can be summed at the end.
+//
+// Samples are non-negative ints; negative values are counted as 0.
+
+#ifndef ONLINE_STATS_H
+#define ONLINE_STATS_H
+
+#include <limits.h>
+#include <string.h>
+
+#define STATS_SUB_BITS 6                                        // 64 buckets per power of two
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_BUCKETS ((31 - STATS_SUB_BITS + 1) * STATS_SUB_BUCKETS)
+
+// Summary of one metric
+typedef struct {
+    long long count;                       // Samples seen
+    long long sum;                         // Sum of the samples (exact mean)
+    double mean;                           // Running mean (Welford)
+    double m2;                             // Sum of squared deviations from the mean
+    int min;                               // Smallest sample, INT_MAX when empty
+    int max;                               // Largest sample, 0 when empty
+    long long buckets[STATS_BUCKETS];      // Histogram for the percentiles
+} OnlineStats;
+
+static inline void onlineStatsInit(OnlineStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->min = INT_MAX;
+}
+
+// Histogram bucket of a non-negative value
+static inline int onlineStatsBucket(int value) {
+    if (value < 2 * STATS_SUB_BUCKETS) return value;
+    int msb = 31 - __builtin_clz((unsigned)value);
+    int shift = msb - STATS_SUB_BITS;
+    return ((shift + 1) << STATS_SUB_BITS) + ((value >> shift) - STATS_SUB_BUCKETS);
+}
+
+// Midpoint of the values that fall into a bucket
+static inline int onlineStatsBucketValue(int bucket) {
+    if (bucket < 2 * STATS_SUB_BUCKETS) return bucket;
+    int shift = (bucket >> STATS_SUB_BITS) - 1;
+    int lower = ((bucket & (STATS_SUB_BUCKETS - 1)) + STATS_SUB_BUCKETS) << shift;
+    return lower + ((1 << shift) - 1) / 2;
+}
+
+// Add one sample: O(1)
+static inline void onlineStatsAdd(OnlineStats *stats, int value) {
+    if (value < 0) value = 0;
+    stats->count++;
+    stats->sum += value;
+    double delta = value - stats->mean;
+    stats->mean += delta / (double)stats->count;
+    stats->m2 += delta * (value - stats->mean);
+    if (value < stats->min) stats->min = value;
+    if (value > stats->max) stats->max = value;
+    stats->buckets[onlineStatsBucket(value)]++;
+}
+
+// Add every sample of from into into
+static inline void onlineStatsMerge(OnlineStats *into, const OnlineStats *from) {
+    if (from->count == 0) return;
+    long long count = into->count + from->count;
+    double delta = from->mean - into->mean;
+    into->mean += delta * (double)from->count / (double)count;
+    into->m2 += from->m2 + delta * delta * (double)into->count * (double)from->count / (double)count;
+    into->count = count;
+    into->sum += from->sum;
+    if (from->min < into->min) into->min = from->min;
+    if (from->max > into->max) into->max = from->max;
+    for (int b = 0; b < STATS_BUCKETS; b++) {
+        into->buckets[b] += from->buckets[b];
+    }
+}
+
+static inline double onlineStatsMean(const OnlineStats *stats) {
+    return stats->count > 0 ? (double)stats->sum / (double)stats->count : 0.0;
+}
+
+// Sample variance
+static inline double onlineStatsVariance(const OnlineStats *stats) {
+    return stats->count > 1 ? stats->m2 / (double)(stats->count - 1) : 0.0;
+}
+
+// Sample standard deviation
+// Newton's method, so the simulators do not need to link libm
+static inline double onlineStatsStddev(const OnlineStats *stats) {
+    double variance = onlineStatsVariance(stats);
+    if (variance <= 0.0) return 0.0;
+    double root = variance > 1.0 ? variance : 1.0;
+    for (int i = 0; i < 64; i++) {
+        root = 0.5 * (root + variance / root);
+    }
+    return root;
+}
+
+// Value at or below which percent% of the samples lie (nearest rank)
+static inline int onlineStatsPercentile(const OnlineStats *stats, double percent) {
+    if (stats->count == 0) return 0;
+    double exactRank = percent / 100.0 * (double)stats->count;
+    long long rank = (long long)exactRank;
+    if ((double)rank < exactRank) rank++;
+    if (rank < 1) rank = 1;
+
+    long long seen = 0;
+    for (int b = 0; b < STATS_BUCKETS; b++) {
+        seen += stats->buckets[b];
+        if (seen >= rank) {
+            int value = onlineStatsBucketValue(b);
+            if (value < stats->min) value = stats->min;
+            if (value > stats->max) value = stats->max;
+            return value;
+        }
+    }
+    return stats->max;
+}
+
+#endif
@@ -0,0 +1,79 @@
+// Hardware event counters (Linux perf_event_open) for the simulators'
+// speed reports.
+//
+// A counter opened with perfCounterOpen() counts the calling thread and every
+// thread it creates afterwards, in user space only, so it works with the
+// default perf_event_paranoid setting. On systems without perf support (other
+// kernels, containers, VMs without a PMU) opening fails and the callers
+// report the count as unavailable.
+
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// One open hardware counter
+typedef struct {
+    int fd;                // perf event file descriptor, -1 if unavailable
+} PerfCounter;
+
+// Open a counter for a PERF_COUNT_HW_* event (e.g. PERF_COUNT_HW_CACHE_MISSES)
+// The counter starts disabled; returns false if it cannot be opened
+static inline bool perfCounterOpen(PerfCounter *counter, uint64_t hardwareEvent) {
+    counter->fd = -1;
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = hardwareEvent;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counter->fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    (void)hardwareEvent;
+#endif
+    return counter->fd >= 0;
+}
+
+// Reset the count to zero and start counting
+static inline void perfCounterStart(PerfCounter *counter) {
+#ifdef __linux__
+    if (counter->fd < 0) return;
+    ioctl(counter->fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(counter->fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+// Stop counting and return the count, or -1 if the counter is unavailable
+// Counts of threads that have exited are included
+static inline long long perfCounterStop(PerfCounter *counter) {
+#ifdef __linux__
+    if (counter->fd < 0) return -1;
+    ioctl(counter->fd, PERF_EVENT_IOC_DISABLE, 0);
+    uint64_t value;
+    if (read(counter->fd, &value, sizeof(value)) != (ssize_t)sizeof(value)) return -1;
+    return (long long)value;
+#else
+    return -1;
+#endif
+}
+
+// Release the counter
+static inline void perfCounterClose(PerfCounter *counter) {
+    if (counter->fd >= 0) close(counter->fd);
+    counter->fd = -1;
+}
+
+#endif
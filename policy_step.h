@@ -0,0 +1,66 @@
+// The scheduling decision of one scheduler pass, shared by STRF.c's
+// threaded engine and the sequential simulators in sweep.c, so both pick
+// the same process at every step.
+//
+// A policy is four hooks, passed as constants so that an always-inlined
+// caller gets each one as a direct (usually inlined) call:
+//     onArrival(idx)                     key of a process entering the ready queue
+//     onPreempt(idx)                     key of a preempted process going back in
+//     shouldPreempt(running, candidate, used)
+//                                        replace the running process by the
+//                                        head of the ready queue?
+//     usesQuantum                        the running process yields after
+//                                        quantum units (Round Robin)
+// The running process is kept out of the ready queue and goes back in (with
+// a fresh key) when it is preempted. Everything else (the clock, slice
+// lengths, metrics, threads) is up to the caller.
+
+#ifndef POLICY_STEP_H
+#define POLICY_STEP_H
+
+#include <stdbool.h>
+#include "ready_queue.h"
+
+// The process holding the CPU between scheduler passes
+typedef struct {
+    int running;           // Process holding the CPU, -1 if none
+    int used;              // Time units it has had since it was last dispatched
+    bool preempted;        // The last policyStep() took the CPU from it
+} PolicyState;
+
+// Put an arrived process in the ready queue with its policy key
+static inline __attribute__((always_inline))
+void policyAdmit(ReadyQueue *queue, long key[], int idx, long (*onArrival)(int idx)) {
+    key[idx] = onArrival(idx);
+    readyQueuePush(queue, idx);
+}
+
+// Let the policy decide whether the head of the ready queue takes the CPU
+// from the running process, and return the process to run next (-1 if there
+// is none); the ready queue keeps the head at the top of the heap, so this
+// is O(1) unless the CPU changes hands
+// The caller sets state->running to -1 when the running process finishes
+static inline __attribute__((always_inline))
+int policyStep(ReadyQueue *queue, long key[], PolicyState *state,
+               long (*onPreempt)(int idx), bool (*shouldPreempt)(int running, int candidate, int used),
+               bool usesQuantum, int quantum) {
+    int candidate = readyQueuePeek(queue);
+    state->preempted = false;
+    if (state->running != -1 && candidate != -1 && shouldPreempt(state->running, candidate, state->used)) {
+        state->preempted = true;
+        key[state->running] = onPreempt(state->running);
+        readyQueuePush(queue, state->running);
+        state->running = -1;
+    } else if (state->running != -1 && usesQuantum && state->used >= quantum) {
+        // Quantum expired with nobody waiting: keep running on a fresh quantum
+        state->used = 0;
+    }
+    if (state->running == -1 && candidate != -1) {
+        state->running = readyQueuePeek(queue);
+        readyQueueRemove(queue, state->running);
+        state->used = 0;
+    }
+    return state->running;
+}
+
+#endif
@@ -0,0 +1,122 @@
+// Indexed binary min-heap of arrived processes waiting for the CPU, shared
+// by STRF.c's scheduler and the simulators in sweep.c.
+//
+// The queue holds process indices and orders them by two columns the
+// caller owns: key[] (what the policy sorts by, e.g. the Remaining Time
+// under SRTF) and then sequence[] (arrival order), so equal keys go to the
+// process that arrived first. The caller sets a process's key before
+// pushing it and must not change it while the process is queued, except
+// downwards followed by readyQueueDecreaseKey().
+
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include <stdbool.h>
+
+// Under SRTF ties resolve exactly like the linear scan in STRF.c's
+// findShortestJob (earliest arrival, i.e. lowest index of the sorted table, wins)
+// pos[] maps a process index to its slot in heap[] (-1 if not queued),
+// which gives O(log n) decrease-key and removal of arbitrary processes
+typedef struct {
+    const long *key;       // Policy key of each process (STRF.c: queueKey column)
+    const long *sequence;  // Arrival order of each process
+    int *heap;             // heap[k] = index into proc[]
+    int *pos;              // pos[i] = slot of proc[i] in heap[], or -1
+    int size;              // Number of queued processes
+} ReadyQueue;
+
+// Returns true if proc[a] should be scheduled before proc[b]
+static inline bool readyQueueLess(ReadyQueue *rq, int a, int b) {
+    if (rq->key[a] != rq->key[b]) {
+        return rq->key[a] < rq->key[b];
+    }
+    return rq->sequence[a] < rq->sequence[b];
+}
+
+// Place process idx at heap slot k and record its position
+static inline void readyQueuePlace(ReadyQueue *rq, int k, int idx) {
+    rq->heap[k] = idx;
+    rq->pos[idx] = k;
+}
+
+// Move the entry at slot k towards the root until the heap order holds
+static inline void readyQueueSiftUp(ReadyQueue *rq, int k) {
+    int idx = rq->heap[k];
+
+    while (k > 0) {
+        int parent = (k - 1) / 2;
+        if (!readyQueueLess(rq, idx, rq->heap[parent])) break;
+        readyQueuePlace(rq, k, rq->heap[parent]);
+        k = parent;
+    }
+    readyQueuePlace(rq, k, idx);
+}
+
+// Move the entry at slot k towards the leaves until the heap order holds
+static inline void readyQueueSiftDown(ReadyQueue *rq, int k) {
+    int idx = rq->heap[k];
+
+    while (2 * k + 1 < rq->size) {
+        int child = 2 * k + 1;
+        if (child + 1 < rq->size && readyQueueLess(rq, rq->heap[child + 1], rq->heap[child])) {
+            child++;
+        }
+        if (!readyQueueLess(rq, rq->heap[child], idx)) break;
+        readyQueuePlace(rq, k, rq->heap[child]);
+        k = child;
+    }
+    readyQueuePlace(rq, k, idx);
+}
+
+// Initialise an empty ready queue over processes 0..n-1, ordered by key[]
+// and then sequence[]
+// heap[] and pos[] must each hold at least n entries
+static inline void readyQueueInit(ReadyQueue *rq, const long key[], const long sequence[], int n, int heap[], int pos[]) {
+    rq->key = key;
+    rq->sequence = sequence;
+    rq->heap = heap;
+    rq->pos = pos;
+    rq->size = 0;
+    for (int i = 0; i < n; i++) {
+        pos[i] = -1;
+    }
+}
+
+// Add an arrived process to the ready queue: O(log n)
+static inline void readyQueuePush(ReadyQueue *rq, int idx) {
+    rq->size++;
+    readyQueuePlace(rq, rq->size - 1, idx);
+    readyQueueSiftUp(rq, rq->size - 1);
+}
+
+// Index of the process with the shortest Remaining Time, or -1 if empty: O(1)
+static inline int readyQueuePeek(ReadyQueue *rq) {
+    return rq->size > 0 ? rq->heap[0] : -1;
+}
+
+// Remove any queued process (e.g. once it completes): O(log n)
+static inline void readyQueueRemove(ReadyQueue *rq, int idx) {
+    int k = rq->pos[idx];
+    if (k < 0) return;
+
+    rq->pos[idx] = -1;
+    rq->size--;
+    if (k == rq->size) return;
+
+    // Fill the hole with the last entry and restore the heap order around it
+    int moved = rq->heap[rq->size];
+    readyQueuePlace(rq, k, moved);
+    readyQueueSiftUp(rq, k);
+    if (rq->pos[moved] == k) {
+        readyQueueSiftDown(rq, k);
+    }
+}
+
+// Restore heap order after proc[idx].queueKey decreased: O(log n)
+static inline void readyQueueDecreaseKey(ReadyQueue *rq, int idx) {
+    if (rq->pos[idx] >= 0) {
+        readyQueueSiftUp(rq, rq->pos[idx]);
+    }
+}
+
+#endif
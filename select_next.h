@@ -0,0 +1,56 @@
+// Compile-time specialised "select next process" loops, shared by the
+// simulators.
+//
+// DEFINE_SELECT_NEXT(NAME, TYPE, KEY) expands to
+//     static inline int NAME(TYPE proc[], int n, int currentTime)
+// which returns the index of the arrived, unfinished process with the
+// smallest proc[i].KEY, or -1 if there is none. Ties go to the lowest index.
+// Any int is a valid key (a burst of INT_MAX included): the first candidate
+// is taken as the best so far instead of comparing against a sentinel.
+// TYPE only needs int fields arrivalTime, finished and KEY.
+//
+// Each policy gets its own copy of the loop with the key read written out
+// in place, so the compiler inlines and vectorises it exactly like a
+// hand-written scan; no comparator is called through a pointer.
+//     SRTF: DEFINE_SELECT_NEXT(findShortestJob, Process, remainingTime)
+//     SJF:  DEFINE_SELECT_NEXT(findShortestBurst, Process, burstTime)
+//     FCFS: DEFINE_SELECT_NEXT(findEarliestArrival, Process, arrivalTime)
+// DEFINE_SELECT_NEXT_COLUMNS does the same for a structure-of-arrays table.
+//
+// proc[] must be sorted by Arrival Time (as the simulators do before
+// scheduling): the scan stops at the first process that has not arrived.
+
+#ifndef SELECT_NEXT_H
+#define SELECT_NEXT_H
+
+#define DEFINE_SELECT_NEXT(NAME, TYPE, KEY)                                   \
+    static inline int NAME(TYPE proc[], int n, int currentTime) {             \
+        int best = -1;                                                        \
+        int bestKey = 0;                                                      \
+        for (int i = 0; i < n && proc[i].arrivalTime <= currentTime; i++) {   \
+            if (!proc[i].finished && (best == -1 || proc[i].KEY < bestKey)) { \
+                bestKey = proc[i].KEY;                                        \
+                best = i;                                                     \
+            }                                                                 \
+        }                                                                     \
+        return best;                                                          \
+    }
+
+// Same scan over a structure-of-arrays table: TYPE holds one pointer per
+// field (arrivalTime, finished and KEY), so the loop reads only those three
+// contiguous columns.
+//     static inline int NAME(const TYPE *table, int n, int currentTime)
+#define DEFINE_SELECT_NEXT_COLUMNS(NAME, TYPE, KEY)                               \
+    static inline int NAME(const TYPE *table, int n, int currentTime) {           \
+        int best = -1;                                                            \
+        int bestKey = 0;                                                          \
+        for (int i = 0; i < n && table->arrivalTime[i] <= currentTime; i++) {     \
+            if (!table->finished[i] && (best == -1 || table->KEY[i] < bestKey)) { \
+                bestKey = table->KEY[i];                                          \
+                best = i;                                                         \
+            }                                                                     \
+        }                                                                         \
+        return best;                                                              \
+    }
+
+#endif
@@ -0,0 +1,209 @@
+// Vectorised shortest-remaining-time selection for the structure-of-arrays
+// Process table.
+//
+// selectShortestRemaining(arrivalTime, remainingTime, finished, n, currentTime)
+// returns the index of the process with the smallest remainingTime among
+// those with arrivalTime <= currentTime and !finished, or -1 if there is
+// none. Ties go to the lowest index, exactly like findShortestJob's scan.
+// Unlike select_next.h the columns do not need to be sorted by Arrival Time:
+// every row is tested, with the arrival and finished checks turned into a
+// lane mask instead of branches.
+//
+// Three kernels compute the same result:
+//   scalar  - plain loop, used on every other CPU and for the tail of a scan
+//   sse4.1  - 4 lanes per step (pmovzxbd widens finished, blendvps selects)
+//   avx2    - 8 lanes per step
+// Each lane keeps its own running minimum and the index it was found at
+// (-1 until the lane has seen a candidate, so a key of INT_MAX is still
+// selectable); lanes see increasing indices, so a strict "<" keeps the first
+// occurrence and the final reduction picks the lowest index among equal minima.
+//
+// The best kernel the CPU supports is chosen on first use
+// (__builtin_cpu_supports), so the program can be built without -mavx2 and
+// still run on older x86 machines and on other architectures.
+
+#ifndef SELECT_SIMD_H
+#define SELECT_SIMD_H
+
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SELECT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Below this many rows the lane setup and reduction cost more than the scan
+#define SELECT_SIMD_MIN_ROWS 16
+
+// Signature shared by every kernel
+typedef int (*SelectKernel)(const int *arrivalTime, const int *remainingTime,
+                            const unsigned char *finished, int n, int currentTime);
+
+// Scalar kernel over rows [start, n), also used for the tail of the SIMD scans
+// *bestKey is only meaningful when a row is returned
+static inline int selectShortestRemainingFrom(const int *arrivalTime, const int *remainingTime,
+                                              const unsigned char *finished, int start, int n,
+                                              int currentTime, int *bestKey) {
+    int best = -1;
+    int key = 0;
+    for (int i = start; i < n; i++) {
+        if (!finished[i] && arrivalTime[i] <= currentTime && (best == -1 || remainingTime[i] < key)) {
+            key = remainingTime[i];
+            best = i;
+        }
+    }
+    *bestKey = key;
+    return best;
+}
+
+static inline int selectShortestRemainingScalar(const int *arrivalTime, const int *remainingTime,
+                                                const unsigned char *finished, int n, int currentTime) {
+    int key;
+    return selectShortestRemainingFrom(arrivalTime, remainingTime, finished, 0, n, currentTime, &key);
+}
+
+#ifdef SELECT_SIMD_X86
+
+// Combine the per-lane minima of a vector scan with the scalar tail
+// Lane indices are all below tailStart, so the tail only wins on a strictly smaller key
+static inline int selectReduceLanes(const int *laneKey, const int *laneIndex, int lanes,
+                                    int tailBest, int tailKey) {
+    int best = -1;
+    int key = 0;
+    for (int l = 0; l < lanes; l++) {
+        if (laneIndex[l] < 0) continue;
+        if (best == -1 || laneKey[l] < key || (laneKey[l] == key && laneIndex[l] < best)) {
+            key = laneKey[l];
+            best = laneIndex[l];
+        }
+    }
+    if (tailBest >= 0 && (best == -1 || tailKey < key)) best = tailBest;
+    return best;
+}
+
+__attribute__((target("sse4.1")))
+static int selectShortestRemainingSSE41(const int *arrivalTime, const int *remainingTime,
+                                        const unsigned char *finished, int n, int currentTime) {
+    const __m128i now = _mm_set1_epi32(currentTime);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i none = _mm_set1_epi32(-1);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i bestKey = _mm_setzero_si128();
+    __m128i bestIndex = none;
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int done4;
+        memcpy(&done4, finished + i, sizeof(done4));
+        __m128i arrival = _mm_loadu_si128((const __m128i *)(arrivalTime + i));
+        __m128i remaining = _mm_loadu_si128((const __m128i *)(remainingTime + i));
+        __m128i done = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(done4));
+        // Lanes that are waiting: arrived (!(arrival > now)) and not finished
+        __m128i excluded = _mm_or_si128(_mm_cmpgt_epi32(arrival, now),
+                                        _mm_xor_si128(_mm_cmpeq_epi32(done, zero), none));
+        // Take the row if it beats the lane's minimum, or the lane has none
+        // yet: bestIndex is -1 there, and the blends only read each lane's sign bit
+        __m128i better = _mm_or_si128(_mm_cmplt_epi32(remaining, bestKey), bestIndex);
+        __m128 smaller = _mm_castsi128_ps(_mm_andnot_si128(excluded, better));
+        bestKey = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(bestKey), _mm_castsi128_ps(remaining), smaller));
+        bestIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(bestIndex), _mm_castsi128_ps(index), smaller));
+        index = _mm_add_epi32(index, step);
+    }
+
+    int laneKey[4], laneIndex[4], tailKey;
+    _mm_storeu_si128((__m128i *)laneKey, bestKey);
+    _mm_storeu_si128((__m128i *)laneIndex, bestIndex);
+    int tailBest = selectShortestRemainingFrom(arrivalTime, remainingTime, finished, i, n,
+                                               currentTime, &tailKey);
+    return selectReduceLanes(laneKey, laneIndex, 4, tailBest, tailKey);
+}
+
+__attribute__((target("avx2")))
+static int selectShortestRemainingAVX2(const int *arrivalTime, const int *remainingTime,
+                                       const unsigned char *finished, int n, int currentTime) {
+    const __m256i now = _mm256_set1_epi32(currentTime);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i none = _mm256_set1_epi32(-1);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i bestKey = _mm256_setzero_si256();
+    __m256i bestIndex = none;
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i arrival = _mm256_loadu_si256((const __m256i *)(arrivalTime + i));
+        __m256i remaining = _mm256_loadu_si256((const __m256i *)(remainingTime + i));
+        __m256i done = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(finished + i)));
+        // Lanes that are waiting: arrived (!(arrival > now)) and not finished
+        __m256i excluded = _mm256_or_si256(_mm256_cmpgt_epi32(arrival, now),
+                                           _mm256_xor_si256(_mm256_cmpeq_epi32(done, zero), none));
+        // Take the row if it beats the lane's minimum, or the lane has none
+        // yet: bestIndex is -1 there, and the blends only read each lane's sign bit
+        __m256i better = _mm256_or_si256(_mm256_cmpgt_epi32(bestKey, remaining), bestIndex);
+        __m256 smaller = _mm256_castsi256_ps(_mm256_andnot_si256(excluded, better));
+        bestKey = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestKey),
+                                                       _mm256_castsi256_ps(remaining), smaller));
+        bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex),
+                                                         _mm256_castsi256_ps(index), smaller));
+        index = _mm256_add_epi32(index, step);
+    }
+
+    int laneKey[8], laneIndex[8], tailKey;
+    _mm256_storeu_si256((__m256i *)laneKey, bestKey);
+    _mm256_storeu_si256((__m256i *)laneIndex, bestIndex);
+    int tailBest = selectShortestRemainingFrom(arrivalTime, remainingTime, finished, i, n,
+                                               currentTime, &tailKey);
+    return selectReduceLanes(laneKey, laneIndex, 8, tailBest, tailKey);
+}
+
+#endif
+
+// Kernel called name ("scalar", "sse4.1" or "avx2"), or NULL if this CPU
+// cannot run it
+static inline SelectKernel selectKernelByName(const char *name) {
+    if (strcmp(name, "scalar") == 0) return selectShortestRemainingScalar;
+#ifdef SELECT_SIMD_X86
+    __builtin_cpu_init();
+    if (strcmp(name, "sse4.1") == 0 && __builtin_cpu_supports("sse4.1")) {
+        return selectShortestRemainingSSE41;
+    }
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        return selectShortestRemainingAVX2;
+    }
+#endif
+    return NULL;
+}
+
+// Widest kernel this CPU supports, with its name
+static inline SelectKernel selectBestKernel(const char **name) {
+    static const char *const preference[] = {"avx2", "sse4.1", "scalar"};
+    for (size_t k = 0; k < sizeof(preference) / sizeof(preference[0]); k++) {
+        SelectKernel kernel = selectKernelByName(preference[k]);
+        if (kernel != NULL) {
+            if (name != NULL) *name = preference[k];
+            return kernel;
+        }
+    }
+    return selectShortestRemainingScalar;
+}
+
+// Dispatching entry point: resolves the kernel once, then calls it directly
+// Short tables go straight to the scalar loop
+static inline int selectShortestRemaining(const int *arrivalTime, const int *remainingTime,
+                                          const unsigned char *finished, int n, int currentTime) {
+    if (n < SELECT_SIMD_MIN_ROWS) {
+        return selectShortestRemainingScalar(arrivalTime, remainingTime, finished, n, currentTime);
+    }
+    static _Atomic(SelectKernel) resolved = NULL;
+    SelectKernel kernel = atomic_load_explicit(&resolved, memory_order_relaxed);
+    if (kernel == NULL) {
+        kernel = selectBestKernel(NULL);
+        atomic_store_explicit(&resolved, kernel, memory_order_relaxed);
+    }
+    return kernel(arrivalTime, remainingTime, finished, n, currentTime);
+}
+
+#endif
@@ -0,0 +1,136 @@
+// Microbenchmark for the vectorised selection kernels (select_simd.h).
+//
+// For table sizes N = 8, 16, 32, ... up to 1M (or the given maximum) it
+// times the scalar, SSE4.1 and AVX2 arg-min kernels over the same columns
+// and queries and checks that every kernel picks the same process. Kernels
+// the CPU does not support are skipped. The table looks like a mid-run
+// Process table: random arrivals, roughly half the processes finished, and
+// query times spread over the arrivals so the mask is neither empty nor full.
+// Each size runs about the same number of row visits, so small N measure
+// the per-call overhead and large N the streaming rate.
+//
+// Terminal code:
+// gcc -O2 select_simd_bench.c -o select_simd_bench
+// ./select_simd_bench [max processes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "select_simd.h"
+
+#define BENCH_ROUNDS 5                // Best of this many timed rounds is reported
+#define ROWS_PER_SIZE (32L << 20)     // Row visits per kernel and round
+#define NUM_KERNELS 3
+
+// Wall-clock seconds since an arbitrary point
+double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    long maxN = argc > 1 ? atol(argv[1]) : 1L << 20;
+    if (maxN < 8 || maxN > (1L << 28)) {
+        fprintf(stderr, "Usage: %s [max processes, 8..%ld]\n", argv[0], 1L << 28);
+        return 1;
+    }
+
+    const char *names[NUM_KERNELS] = {"scalar", "sse4.1", "avx2"};
+    SelectKernel kernels[NUM_KERNELS];
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        kernels[k] = selectKernelByName(names[k]);
+    }
+    const char *dispatched = NULL;
+    selectBestKernel(&dispatched);
+
+    int *arrivalTime = malloc((size_t)maxN * sizeof(int));
+    int *remainingTime = malloc((size_t)maxN * sizeof(int));
+    unsigned char *finished = malloc((size_t)maxN);
+    if (arrivalTime == NULL || remainingTime == NULL || finished == NULL) {
+        fprintf(stderr, "Error allocating memory for %ld processes\n", maxN);
+        return 1;
+    }
+
+    printf("Arg-min of Remaining Time over arrived, unfinished processes\n");
+    printf("Dispatch picks: %s (best of %d rounds)\n\n", dispatched, BENCH_ROUNDS);
+    printf("%10s", "N");
+    for (int k = 0; k < NUM_KERNELS; k++) printf(" %12s", names[k]);
+    printf(" %10s %10s\n", "sse4.1 x", "avx2 x");
+    printf("%10s", "");
+    for (int k = 0; k < NUM_KERNELS; k++) printf(" %12s", "ns/call");
+    printf("\n");
+
+    int mismatches = 0;
+    volatile int sink = 0;
+    srand(12345);
+
+    for (long n = 8; n <= maxN; n *= 2) {
+        for (long i = 0; i < n; i++) {
+            arrivalTime[i] = rand() % (int)(4 * n);
+            remainingTime[i] = 1 + rand() % 1000;
+            finished[i] = (unsigned char)(rand() % 2);
+        }
+
+        // Query times and the scalar kernel's answers
+        int queries = (int)(ROWS_PER_SIZE / n);
+        if (queries < 8) queries = 8;
+        int *times = malloc((size_t)queries * sizeof(int));
+        int *expected = malloc((size_t)queries * sizeof(int));
+        if (times == NULL || expected == NULL) {
+            fprintf(stderr, "Error allocating memory for %d queries\n", queries);
+            return 1;
+        }
+        for (int q = 0; q < queries; q++) {
+            times[q] = rand() % (int)(4 * n);
+            expected[q] = selectShortestRemainingScalar(arrivalTime, remainingTime, finished,
+                                                        (int)n, times[q]);
+        }
+
+        double best[NUM_KERNELS] = {1e30, 1e30, 1e30};
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            for (int k = 0; k < NUM_KERNELS; k++) {
+                if (kernels[k] == NULL) continue;
+                double start = now();
+                for (int q = 0; q < queries; q++) {
+                    int idx = kernels[k](arrivalTime, remainingTime, finished, (int)n, times[q]);
+                    if (idx != expected[q]) mismatches++;
+                    sink += idx;
+                }
+                double elapsed = now() - start;
+                if (elapsed < best[k]) best[k] = elapsed;
+            }
+        }
+
+        printf("%10ld", n);
+        for (int k = 0; k < NUM_KERNELS; k++) {
+            if (kernels[k] == NULL) {
+                printf(" %12s", "unsupported");
+            } else {
+                printf(" %12.1f", best[k] / queries * 1e9);
+            }
+        }
+        for (int k = 1; k < NUM_KERNELS; k++) {
+            if (kernels[k] == NULL) {
+                printf(" %10s", "-");
+            } else {
+                printf(" %9.2fx", best[0] / best[k]);
+            }
+        }
+        printf("\n");
+
+        free(times);
+        free(expected);
+    }
+
+    free(arrivalTime);
+    free(remainingTime);
+    free(finished);
+
+    if (mismatches > 0) {
+        printf("\nFAIL: %d selections differ from the scalar kernel\n", mismatches);
+        return 1;
+    }
+    printf("\nOK: every kernel picks the same processes as the scalar loop\n");
+    return 0;
+}
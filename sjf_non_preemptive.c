@@ -2,15 +2,20 @@
 //Terminal code:
 //gcc sjf_non_preemptive.c -o sjf
 //.\sjf
+//.\sjf --trace=workload.csv   (load processes from a trace file instead)
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "trace_reader.h"
+#include "select_next.h"
+#include "arrival_sort.h"
 
-#define MAX_PROC 10   // maximum allowed processes
+#define MAX_PROC 10   // maximum allowed processes when entered by hand
 
 // Structure representing each process
 typedef struct {
-    char pid[6];           // Process ID (P1, P2, ...)
+    char pid[16];          // Process ID (P1, P2, ...)
     int arrivalTime;       // Time when the process arrives
     int burstTime;         // CPU burst duration
     int startTime;         // Time when the process starts execution
@@ -21,54 +26,98 @@ typedef struct {
     int finished;          // 0 = not completed, 1 = completed
 } Process;
 
-int main() {
+// Arrived, unfinished process with the smallest Burst Time (see select_next.h)
+DEFINE_SELECT_NEXT(selectShortestBurst, Process, burstTime)
+
+int main(int argc, char *argv[]) {
     int n;
-    Process proc[MAX_PROC];
-    int i, j;
+    Process *proc;
+    int i;
+    const char *traceFile = NULL;
 
     // ---------------------------
-    // Input number of processes
+    // Command-line options
     // ---------------------------
-    printf("Enter number of processes (1-%d): ", MAX_PROC);
-    if (scanf("%d", &n) != 1) return 0;
-
-    while (n < 1 || n > MAX_PROC) {
-        printf("Invalid number. Enter between 1 and %d: ", MAX_PROC);
-        if (scanf("%d", &n) != 1) return 0;
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--trace=", 8) == 0) {
+            traceFile = argv[i] + 8;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--trace=FILE]\n", argv[0]);
+            return 1;
+        }
     }
 
-    // ---------------------------
-    // Read arrival & burst times
-    // ---------------------------
-    printf("\nEnter arrival and burst times:\n");
-    for (i = 0; i < n; i++) {
-
-        // Assign PID automatically
-        snprintf(proc[i].pid, sizeof(proc[i].pid), "P%d", i+1);
-
-        // Arrival time
-        printf("Process %d: Arrival = ", i+1);
-        while (scanf("%d", &proc[i].arrivalTime) != 1) {
-            while (getchar() != '\n');
-            printf("Invalid. Enter integer for arrival: ");
+    if (traceFile != NULL) {
+        // ---------------------------
+        // Load processes from a trace file
+        // ---------------------------
+        Trace trace;
+        n = traceLoad(traceFile, &trace);
+        if (n < 0) return 1;
+
+        proc = malloc((size_t)n * sizeof(Process));
+        if (proc == NULL) {
+            fprintf(stderr, "Error allocating memory for %d processes\n", n);
+            return 1;
         }
-        while (proc[i].arrivalTime < 0) {
-            printf("Arrival time cannot be negative. Enter again: ");
-            scanf("%d", &proc[i].arrivalTime);
+
+        for (i = 0; i < n; i++) {
+            snprintf(proc[i].pid, sizeof(proc[i].pid), "P%d", trace.records[i].pid);
+            proc[i].arrivalTime = trace.records[i].arrivalTime;
+            proc[i].burstTime = trace.records[i].burstTime;
         }
+        traceFree(&trace);
+    } else {
+        // ---------------------------
+        // Input number of processes
+        // ---------------------------
+        printf("Enter number of processes (1-%d): ", MAX_PROC);
+        if (scanf("%d", &n) != 1) return 0;
 
-        // Burst time
-        printf("         Burst   = ");
-        while (scanf("%d", &proc[i].burstTime) != 1) {
-            while (getchar() != '\n');
-            printf("Invalid. Enter integer for burst: ");
+        while (n < 1 || n > MAX_PROC) {
+            printf("Invalid number. Enter between 1 and %d: ", MAX_PROC);
+            if (scanf("%d", &n) != 1) return 0;
         }
-        while (proc[i].burstTime < 1) {
-            printf("Burst time must be at least 1. Enter again: ");
-            scanf("%d", &proc[i].burstTime);
+
+        proc = malloc((size_t)n * sizeof(Process));
+        if (proc == NULL) return 1;
+
+        // ---------------------------
+        // Read arrival & burst times
+        // ---------------------------
+        printf("\nEnter arrival and burst times:\n");
+        for (i = 0; i < n; i++) {
+
+            // Assign PID automatically
+            snprintf(proc[i].pid, sizeof(proc[i].pid), "P%d", i+1);
+
+            // Arrival time
+            printf("Process %d: Arrival = ", i+1);
+            while (scanf("%d", &proc[i].arrivalTime) != 1) {
+                while (getchar() != '\n');
+                printf("Invalid. Enter integer for arrival: ");
+            }
+            while (proc[i].arrivalTime < 0) {
+                printf("Arrival time cannot be negative. Enter again: ");
+                scanf("%d", &proc[i].arrivalTime);
+            }
+
+            // Burst time
+            printf("         Burst   = ");
+            while (scanf("%d", &proc[i].burstTime) != 1) {
+                while (getchar() != '\n');
+                printf("Invalid. Enter integer for burst: ");
+            }
+            while (proc[i].burstTime < 1) {
+                printf("Burst time must be at least 1. Enter again: ");
+                scanf("%d", &proc[i].burstTime);
+            }
         }
+    }
 
-        // Initialize scheduling-related values
+    // Initialize scheduling-related values
+    for (i = 0; i < n; i++) {
         proc[i].startTime = -1;
         proc[i].completionTime = 0;
         proc[i].turnaroundTime = 0;
@@ -79,16 +128,19 @@ int main() {
 
     // -------------------------------------
     // Sort processes by arrival time (stable)
+    // Radix sort on row indices, then each record moves once
     // -------------------------------------
-    for (i = 0; i < n - 1; i++) {
-        for (j = i + 1; j < n; j++) {
-            if (proc[i].arrivalTime > proc[j].arrivalTime) {
-                Process tmp = proc[i];
-                proc[i] = proc[j];
-                proc[j] = tmp;
-            }
-        }
+    int *order = malloc((size_t)n * sizeof(int));
+    Process *sorted = malloc((size_t)n * sizeof(Process));
+    if (order == NULL || sorted == NULL ||
+        !sortIndicesByArrival(&proc[0].arrivalTime, sizeof(Process), n, order)) {
+        fprintf(stderr, "Error allocating memory to sort %d processes\n", n);
+        return 1;
     }
+    for (i = 0; i < n; i++) sorted[i] = proc[order[i]];
+    free(proc);
+    free(order);
+    proc = sorted;
 
     // -------------------------------
     // SJF (Non-preemptive) Simulation
@@ -102,16 +154,8 @@ int main() {
 
     while (completed < n) {
 
-        idx = -1;
-
         // Select process with smallest burst time among arrived & unfinished
-        for (i = 0; i < n; i++) {
-            if (!proc[i].finished && proc[i].arrivalTime <= time) {
-                if (idx == -1 || proc[i].burstTime < proc[idx].burstTime) {
-                    idx = i;
-                }
-            }
-        }
+        idx = selectShortestBurst(proc, n, time);
 
         // If no process has arrived yet, jump to next arrival time
         if (idx == -1) {
@@ -177,5 +221,6 @@ int main() {
     printf("Average Waiting Time    = %.2f\n", totalWaiting / n);
     printf("Average Response Time   = %.2f\n", totalResponse / n);
 
+    free(proc);
     return 0;
 }
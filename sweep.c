@@ -0,0 +1,468 @@
+// Monte Carlo sweep: simulates SRTF and non-preemptive SJF over many
+// randomly generated workloads and reports the average Turnaround, Waiting
+// and Response Times with 95% confidence intervals.
+//
+// Workloads have Poisson arrivals (exponential inter-arrival times) and
+// exponential or Pareto bursts, rounded to whole time units. Workload k is
+// generated from its own RNG stream derived from --seed and k, so results do
+// not depend on the number of threads.
+//
+// The workloads are simulated in parallel by one worker thread per core,
+// which take batches of workload numbers from a shared counter. Each thread
+// makes its decisions with the same ready queue and policy step as STRF.c
+// (ready_queue.h, policy_step.h) and its SRTF and SJF hooks, but
+// sequentially and without printing, so thousands of workloads take seconds.
+// --dump=K prints workload K as a trace file, to replay it through
+// STRF --trace=FILE or sjf --trace=FILE.
+//
+// Terminal code:
+// gcc -O2 sweep.c -o sweep -pthread -lm
+// ./sweep --workloads=10000 --procs=100 --arrival-rate=0.2 --burst=pareto:2.5:1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "policy_step.h"
+
+#define SWEEP_BATCH 16      // Workloads a worker takes from the queue at a time
+#define NUM_POLICIES 2      // SRTF, SJF
+#define NUM_METRICS 3       // Turnaround, Waiting, Response
+
+// Burst time distributions
+typedef enum {
+    BURST_EXPONENTIAL,  // Exponential with mean burstMean
+    BURST_PARETO        // Pareto with shape paretoAlpha and minimum paretoMin
+} BurstDistribution;
+
+// One generated process
+typedef struct {
+    int arrivalTime;       // Time when the process arrives
+    int burstTime;         // CPU burst duration
+    int remainingTime;     // Remaining CPU time (SRTF)
+    int startTime;         // First time the process gets the CPU, -1 before
+} SweepProcess;
+
+// Running mean and variance (Welford), merged across threads at the end
+typedef struct {
+    long count;            // Samples seen
+    double mean;           // Mean of the samples
+    double m2;             // Sum of squared deviations from the mean
+} RunningStats;
+
+// Per-thread state
+typedef struct {
+    pthread_t thread;
+    RunningStats stats[NUM_POLICIES][NUM_METRICS];  // Per-workload averages
+    SweepProcess *procs;                            // Workload being simulated
+    long *key;                                      // Ready queue key of each process
+    long *sequence;                                 // Arrival order of each process (its index)
+    int *heap;                                      // Ready queue storage
+    int *pos;
+} SweepWorker;
+
+// Sweep configuration
+int numWorkloads = 1000;                   // Workloads to simulate
+int procsPerWorkload = 50;                 // Processes in each workload
+double arrivalRate = 0.1;                  // Poisson arrival rate (processes per time unit)
+BurstDistribution burstDistribution = BURST_EXPONENTIAL;
+double burstMean = 5.0;                    // Mean of the exponential burst
+double paretoAlpha = 2.5;                  // Pareto shape
+double paretoMin = 1.0;                    // Pareto minimum (scale)
+uint64_t seed = 1;                         // Base seed of every workload's RNG
+int numThreads = 0;                        // Worker threads, 0 = one per core
+int dumpWorkload = -1;                     // Workload to print as a trace, -1 = none
+
+atomic_int nextWorkload = 0;               // Shared work queue: next workload not yet taken
+static _Thread_local SweepProcess *sweepProcs = NULL;  // Workload the policy hooks of this thread read
+
+const char *policyNames[NUM_POLICIES] = {"SRTF", "SJF"};
+const char *metricNames[NUM_METRICS] = {"Turnaround", "Waiting", "Response"};
+
+// Function prototypes
+bool parseArguments(int argc, char *argv[]);
+void printUsage(const char *program);
+uint64_t rngNext(uint64_t *state);
+double rngUniform(uint64_t *state);
+void generateWorkload(int k, SweepProcess procs[], int n);
+void simulateSRTF(SweepWorker *worker, int n, double averages[]);
+void simulateSJF(SweepWorker *worker, int n, double averages[]);
+void statsAdd(RunningStats *stats, double x);
+void statsMerge(RunningStats *into, const RunningStats *from);
+double confidenceHalfWidth(const RunningStats *stats);
+void *sweepWorker(void *arg);
+
+int main(int argc, char *argv[]) {
+    if (!parseArguments(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Print one workload as a trace file and stop
+    if (dumpWorkload >= 0) {
+        SweepProcess *procs = malloc((size_t)procsPerWorkload * sizeof(SweepProcess));
+        if (procs == NULL) return 1;
+        generateWorkload(dumpWorkload, procs, procsPerWorkload);
+        printf("pid,arrival,burst\n");
+        for (int i = 0; i < procsPerWorkload; i++) {
+            printf("%d,%d,%d\n", i + 1, procs[i].arrivalTime, procs[i].burstTime);
+        }
+        free(procs);
+        return 0;
+    }
+
+    if (numThreads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = cores > 0 ? (int)cores : 1;
+    }
+
+    SweepWorker *workers = calloc((size_t)numThreads, sizeof(SweepWorker));
+    if (workers == NULL) {
+        fprintf(stderr, "Error allocating memory for %d workers\n", numThreads);
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].procs = malloc((size_t)procsPerWorkload * sizeof(SweepProcess));
+        workers[t].key = malloc((size_t)procsPerWorkload * sizeof(long));
+        workers[t].sequence = malloc((size_t)procsPerWorkload * sizeof(long));
+        workers[t].heap = malloc((size_t)procsPerWorkload * sizeof(int));
+        workers[t].pos = malloc((size_t)procsPerWorkload * sizeof(int));
+        if (workers[t].procs == NULL || workers[t].key == NULL || workers[t].sequence == NULL ||
+            workers[t].heap == NULL || workers[t].pos == NULL) {
+            fprintf(stderr, "Error allocating memory for worker %d\n", t);
+            return 1;
+        }
+        for (int i = 0; i < procsPerWorkload; i++) workers[t].sequence[i] = i;
+        if (pthread_create(&workers[t].thread, NULL, sweepWorker, &workers[t]) != 0) {
+            fprintf(stderr, "Error creating worker thread %d\n", t);
+            return 1;
+        }
+    }
+
+    // Merge the per-thread statistics
+    RunningStats totals[NUM_POLICIES][NUM_METRICS];
+    memset(totals, 0, sizeof(totals));
+    for (int t = 0; t < numThreads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        for (int p = 0; p < NUM_POLICIES; p++) {
+            for (int m = 0; m < NUM_METRICS; m++) {
+                statsMerge(&totals[p][m], &workers[t].stats[p][m]);
+            }
+        }
+        free(workers[t].procs);
+        free(workers[t].key);
+        free(workers[t].sequence);
+        free(workers[t].heap);
+        free(workers[t].pos);
+    }
+    free(workers);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("======================================\n");
+    printf("  Monte Carlo Sweep\n");
+    printf("======================================\n\n");
+    printf("Workloads            = %d x %d processes\n", numWorkloads, procsPerWorkload);
+    printf("Arrivals             = Poisson, rate %.4g per time unit\n", arrivalRate);
+    if (burstDistribution == BURST_EXPONENTIAL) {
+        printf("Bursts               = exponential, mean %.4g\n", burstMean);
+    } else {
+        printf("Bursts               = Pareto, alpha %.4g, minimum %.4g\n", paretoAlpha, paretoMin);
+    }
+    printf("Seed                 = %llu\n", (unsigned long long)seed);
+    printf("Threads              = %d\n", numThreads);
+    printf("Wall-clock time      = %.3f s (%.0f workloads/s)\n\n", seconds,
+           seconds > 0 ? numWorkloads / seconds : 0.0);
+
+    printf("Mean of per-workload averages, with 95%% confidence intervals:\n\n");
+    printf("%-8s %-12s %14s %14s %12s\n", "Policy", "Metric", "Mean", "95% CI +/-", "Std Dev");
+    printf("--------------------------------------------------------------\n");
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        for (int m = 0; m < NUM_METRICS; m++) {
+            const RunningStats *stats = &totals[p][m];
+            double stddev = stats->count > 1 ? sqrt(stats->m2 / (double)(stats->count - 1)) : 0.0;
+            printf("%-8s %-12s %14.4f %14.4f %12.4f\n", policyNames[p], metricNames[m],
+                   stats->mean, confidenceHalfWidth(stats), stddev);
+        }
+    }
+    return 0;
+}
+
+// Parse command-line options
+// Returns false if an option is invalid
+bool parseArguments(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        char *end;
+        if (strncmp(argv[i], "--workloads=", 12) == 0) {
+            numWorkloads = (int)strtol(argv[i] + 12, &end, 10);
+            if (*end != '\0' || numWorkloads < 1) {
+                fprintf(stderr, "Invalid number of workloads: %s\n", argv[i] + 12);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--procs=", 8) == 0) {
+            procsPerWorkload = (int)strtol(argv[i] + 8, &end, 10);
+            if (*end != '\0' || procsPerWorkload < 1) {
+                fprintf(stderr, "Invalid number of processes: %s\n", argv[i] + 8);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--arrival-rate=", 15) == 0) {
+            arrivalRate = strtod(argv[i] + 15, &end);
+            if (*end != '\0' || !(arrivalRate > 0)) {
+                fprintf(stderr, "Invalid arrival rate: %s\n", argv[i] + 15);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--burst=exp:", 12) == 0) {
+            burstDistribution = BURST_EXPONENTIAL;
+            burstMean = strtod(argv[i] + 12, &end);
+            if (*end != '\0' || !(burstMean > 0)) {
+                fprintf(stderr, "Invalid exponential mean: %s\n", argv[i] + 12);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--burst=pareto:", 15) == 0) {
+            burstDistribution = BURST_PARETO;
+            paretoAlpha = strtod(argv[i] + 15, &end);
+            if (*end != ':' || !(paretoAlpha > 0)) {
+                fprintf(stderr, "Invalid Pareto parameters: %s\n", argv[i] + 15);
+                return false;
+            }
+            paretoMin = strtod(end + 1, &end);
+            if (*end != '\0' || !(paretoMin > 0)) {
+                fprintf(stderr, "Invalid Pareto parameters: %s\n", argv[i] + 15);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, &end, 10);
+            if (*end != '\0') {
+                fprintf(stderr, "Invalid seed: %s\n", argv[i] + 7);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            numThreads = (int)strtol(argv[i] + 10, &end, 10);
+            if (*end != '\0' || numThreads < 1 || numThreads > 1024) {
+                fprintf(stderr, "Invalid number of threads: %s\n", argv[i] + 10);
+                return false;
+            }
+        } else if (strncmp(argv[i], "--dump=", 7) == 0) {
+            dumpWorkload = (int)strtol(argv[i] + 7, &end, 10);
+            if (*end != '\0' || dumpWorkload < 0) {
+                fprintf(stderr, "Invalid workload number: %s\n", argv[i] + 7);
+                return false;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Print the supported command-line options
+void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --workloads=N          Workloads to simulate (default 1000)\n");
+    fprintf(stderr, "  --procs=N              Processes per workload (default 50)\n");
+    fprintf(stderr, "  --arrival-rate=RATE    Poisson arrivals per time unit (default 0.1)\n");
+    fprintf(stderr, "  --burst=exp:MEAN       Exponential bursts (default exp:5)\n");
+    fprintf(stderr, "  --burst=pareto:A:MIN   Pareto bursts with shape A and minimum MIN\n");
+    fprintf(stderr, "  --seed=S               Base RNG seed (default 1)\n");
+    fprintf(stderr, "  --threads=K            Worker threads (default: one per core)\n");
+    fprintf(stderr, "  --dump=K               Print workload K as a trace file and exit\n");
+}
+
+// splitmix64: small, fast, and good enough to seed and drive each workload
+uint64_t rngNext(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform double in (0, 1]
+double rngUniform(uint64_t *state) {
+    return (double)((rngNext(state) >> 11) + 1) / 9007199254740992.0;
+}
+
+// Fill procs[] with workload k, in arrival order
+void generateWorkload(int k, SweepProcess procs[], int n) {
+    // Derive the workload's stream from the base seed and its number
+    uint64_t state = seed;
+    state = rngNext(&state) ^ (uint64_t)k * 0xD1B54A32D192ED03ULL;
+
+    double clock = 0;
+    for (int i = 0; i < n; i++) {
+        // Poisson process: exponential gaps between arrivals
+        clock += -log(rngUniform(&state)) / arrivalRate;
+        double burst;
+        if (burstDistribution == BURST_EXPONENTIAL) {
+            burst = -log(rngUniform(&state)) * burstMean;
+        } else {
+            burst = paretoMin / pow(rngUniform(&state), 1.0 / paretoAlpha);
+        }
+
+        procs[i].arrivalTime = clock < 1e9 ? (int)clock : 1000000000;
+        procs[i].burstTime = burst < 1 ? 1 : (burst > 1e6 ? 1000000 : (int)ceil(burst));
+    }
+}
+
+// Policy hooks (policy_step.h), the same rules as STRF.c's
+// Ready-queue keys: lower keys run first, equal keys in arrival order
+static long keyRemainingTime(int idx) { return sweepProcs[idx].remainingTime; }
+static long keyBurstTime(int idx) { return sweepProcs[idx].burstTime; }
+
+// SRTF: a process with a shorter Remaining Time (or equal, arriving earlier)
+// takes over
+static bool preemptShorterRemaining(int running, int candidate, int used) {
+    (void)used;
+    int r = sweepProcs[running].remainingTime;
+    int c = sweepProcs[candidate].remainingTime;
+    return c < r || (c == r && candidate < running);
+}
+
+// SJF is non-preemptive: the running process keeps the CPU until it completes
+static bool preemptNever(int running, int candidate, int used) {
+    (void)running;
+    (void)candidate;
+    (void)used;
+    return false;
+}
+
+// Simulate the worker's workload event by event under the policy given by
+// the hooks, making the same decisions as STRF.c --event-driven: each slice
+// runs until the process completes or, if arrivals can preempt it, until the
+// next process arrives
+// Writes the average Turnaround, Waiting and Response Times to averages[]
+static inline __attribute__((always_inline))
+void simulatePolicy(SweepWorker *worker, int n, long (*onArrival)(int idx), long (*onPreempt)(int idx),
+                    bool (*shouldPreempt)(int running, int candidate, int used), bool arrivalsPreempt,
+                    double averages[]) {
+    SweepProcess *procs = worker->procs;
+    ReadyQueue queue;
+    PolicyState cpu = {-1, 0, false};
+    long time = 0;
+    int next = 0, completed = 0;
+    double turnaround = 0, waiting = 0, response = 0;
+
+    sweepProcs = procs;
+    readyQueueInit(&queue, worker->key, worker->sequence, n, worker->heap, worker->pos);
+    for (int i = 0; i < n; i++) {
+        procs[i].remainingTime = procs[i].burstTime;
+        procs[i].startTime = -1;
+    }
+
+    while (completed < n) {
+        while (next < n && procs[next].arrivalTime <= time) {
+            policyAdmit(&queue, worker->key, next++, onArrival);
+        }
+
+        // Jump ahead if the CPU would be idle
+        int idx = policyStep(&queue, worker->key, &cpu, onPreempt, shouldPreempt, false, 0);
+        if (idx == -1) {
+            time = procs[next].arrivalTime;
+            continue;
+        }
+
+        if (procs[idx].startTime < 0) {
+            procs[idx].startTime = (int)time;
+            response += (double)(time - procs[idx].arrivalTime);
+        }
+        long slice = procs[idx].remainingTime;
+        if (arrivalsPreempt && next < n && procs[next].arrivalTime - time < slice) {
+            slice = procs[next].arrivalTime - time;
+        }
+        time += slice;
+        procs[idx].remainingTime -= (int)slice;
+        cpu.used += (int)slice;
+
+        if (procs[idx].remainingTime == 0) {
+            turnaround += (double)(time - procs[idx].arrivalTime);
+            waiting += (double)(time - procs[idx].arrivalTime - procs[idx].burstTime);
+            completed++;
+            cpu.running = -1;
+        }
+    }
+
+    averages[0] = turnaround / n;
+    averages[1] = waiting / n;
+    averages[2] = response / n;
+}
+
+// Shortest Remaining Time First (same decisions as STRF.c)
+void simulateSRTF(SweepWorker *worker, int n, double averages[]) {
+    simulatePolicy(worker, n, keyRemainingTime, keyRemainingTime, preemptShorterRemaining, true, averages);
+}
+
+// Non-preemptive Shortest Job First (same decisions as sjf_non_preemptive.c
+// and STRF.c --policy=sjf: shortest Burst Time first, ties to the earliest arrival)
+// Without preemption a process waits exactly until its first run
+void simulateSJF(SweepWorker *worker, int n, double averages[]) {
+    simulatePolicy(worker, n, keyBurstTime, keyBurstTime, preemptNever, false, averages);
+}
+
+// Add one sample to a running mean and variance
+void statsAdd(RunningStats *stats, double x) {
+    stats->count++;
+    double delta = x - stats->mean;
+    stats->mean += delta / (double)stats->count;
+    stats->m2 += delta * (x - stats->mean);
+}
+
+// Combine two sets of samples (Chan et al. parallel variance)
+void statsMerge(RunningStats *into, const RunningStats *from) {
+    if (from->count == 0) return;
+    long count = into->count + from->count;
+    double delta = from->mean - into->mean;
+    into->mean += delta * (double)from->count / (double)count;
+    into->m2 += from->m2 + delta * delta * (double)into->count * (double)from->count / (double)count;
+    into->count = count;
+}
+
+// Half-width of the 95% confidence interval of the mean
+// Uses Student's t for small sample counts and the normal value otherwise
+double confidenceHalfWidth(const RunningStats *stats) {
+    static const double t95[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (stats->count < 2) return 0.0;
+
+    long df = stats->count - 1;
+    double t = df <= 30 ? t95[df - 1] : 1.96;
+    double stddev = sqrt(stats->m2 / (double)df);
+    return t * stddev / sqrt((double)stats->count);
+}
+
+// Worker thread: takes batches of workloads from the shared counter until
+// none are left, simulating each under both policies
+void *sweepWorker(void *arg) {
+    SweepWorker *worker = (SweepWorker *)arg;
+    double averages[NUM_METRICS];
+
+    while (1) {
+        int first = atomic_fetch_add(&nextWorkload, SWEEP_BATCH);
+        if (first >= numWorkloads) break;
+        int last = first + SWEEP_BATCH < numWorkloads ? first + SWEEP_BATCH : numWorkloads;
+
+        for (int k = first; k < last; k++) {
+            generateWorkload(k, worker->procs, procsPerWorkload);
+
+            simulateSRTF(worker, procsPerWorkload, averages);
+            for (int m = 0; m < NUM_METRICS; m++) statsAdd(&worker->stats[0][m], averages[m]);
+
+            simulateSJF(worker, procsPerWorkload, averages);
+            for (int m = 0; m < NUM_METRICS; m++) statsAdd(&worker->stats[1][m], averages[m]);
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,45 @@
+// Converts a text workload trace into the binary trace format read by
+// STRF.c and sjf_non_preemptive.c (see trace_reader.h).
+// Records are stored sorted by arrival time (ties keep their file order),
+// so the simulators can use the mapped columns directly without sorting.
+//
+// Terminal code:
+// gcc trace_convert.c -o trace_convert
+// ./trace_convert workload.csv workload.bin
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "trace_reader.h"
+#include "arrival_sort.h"
+
+int main(int argc, char *argv[]) {
+    Trace trace;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input trace> <output.bin>\n", argv[0]);
+        return 1;
+    }
+
+    int n = traceLoad(argv[1], &trace);
+    if (n < 0) return 1;
+
+    // Stable radix sort of an index array, then gather the records in order
+    int *order = malloc((size_t)n * sizeof(int));
+    TraceRecord *sorted = malloc((size_t)n * sizeof(TraceRecord));
+    if (order == NULL || sorted == NULL ||
+        !sortIndicesByArrival(&trace.records[0].arrivalTime, sizeof(TraceRecord), n, order)) {
+        fprintf(stderr, "Error allocating memory for %d records\n", n);
+        return 1;
+    }
+    for (int i = 0; i < n; i++) sorted[i] = trace.records[order[i]];
+
+    int status = traceWriteBinary(argv[2], sorted, n, TRACE_BINARY_SORTED);
+    if (status == 0) {
+        printf("Wrote %d records to %s\n", n, argv[2]);
+    }
+
+    free(order);
+    free(sorted);
+    traceFree(&trace);
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,481 @@
+// Streaming reader for workload trace files, shared by the simulators.
+//
+// Each non-empty line describes one process:
+//     pid, arrival, burst[, priority]
+// Fields may be separated by commas and/or whitespace, '#' starts a comment,
+// and the first line that is not blank or a comment may be a header such as
+// "pid,arrival,burst,priority".
+// Records are validated with the same rules as the interactive prompts:
+// pid >= 1, arrival >= 0 and burst >= 1; no pid may appear twice.
+//
+// The file is read through a large buffer and parsed by hand (no scanf),
+// so millions of rows can be loaded per second.
+// Passing "-" as the path reads from stdin.
+//
+// Huge traces can instead be stored in a compact binary format (written by
+// trace_convert.c) that is mmap'd and read in place:
+//     TraceBinaryHeader, then int32 columns arrival[count], burst[count],
+//     pid[count] and priority[count], in host byte order.
+// traceLoad() accepts either format; traceMap() gives zero-copy access to
+// the columns of a binary trace.
+
+#ifndef TRACE_READER_H
+#define TRACE_READER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TRACE_BUFFER_SIZE (1 << 20)   // Bytes read from the file at a time
+#define TRACE_MAX_FIELDS 4            // pid, arrival, burst, priority
+#define TRACE_BINARY_MAGIC "SRTFBIN1"  // First 8 bytes of a binary trace
+#define TRACE_BINARY_VERSION 1
+#define TRACE_BINARY_SORTED 0x1       // Flag: records are in (stable) arrival order
+#define TRACE_PID_PAGE_BITS 19        // 2^19 pids (64 KB) per page of the seen-pid bitmap
+#define TRACE_PID_PAGES ((INT_MAX >> TRACE_PID_PAGE_BITS) + 1)
+
+// One process as described by a trace line
+typedef struct {
+    int pid;               // Process ID
+    int arrivalTime;       // Time when the process arrives
+    int burstTime;         // CPU burst duration
+    int priority;          // Optional priority, 0 when the column is absent
+} TraceRecord;
+
+// State of an open trace file
+typedef struct {
+    FILE *file;            // Source of the trace
+    const char *path;      // Name used in error messages
+    char *buffer;          // Read buffer
+    size_t pos;            // Next unread byte in buffer
+    size_t len;            // Valid bytes in buffer
+    long line;             // Line number of the record being parsed
+    int started;           // A record or the header line has been read
+    uint64_t **seenPids;   // Bitmap of the pids read so far, in pages allocated on first use
+} TraceReader;
+
+// A whole trace loaded into memory
+typedef struct {
+    TraceRecord *records;  // Records in file order
+    int count;             // Number of records
+    int capacity;          // Allocated records
+} Trace;
+
+// Fixed-size header at the start of a binary trace
+typedef struct {
+    char magic[8];         // TRACE_BINARY_MAGIC
+    uint32_t version;      // TRACE_BINARY_VERSION
+    uint32_t flags;        // TRACE_BINARY_* flags
+    uint64_t count;        // Number of records
+} TraceBinaryHeader;
+
+// Binary trace mapped into memory; the columns point into the mapping
+typedef struct {
+    const int32_t *arrival;    // Arrival Time column
+    const int32_t *burst;      // Burst Time column
+    const int32_t *pid;        // Process ID column
+    const int32_t *priority;   // Priority column
+    int count;                 // Number of records
+    uint32_t flags;            // TRACE_BINARY_* flags from the header
+    const char *path;          // Name used in error messages
+    void *map;                 // Start of the mapping
+    size_t mapSize;            // Length of the mapping
+} TraceMapping;
+
+// Open a trace file for reading
+// Returns 0 on success, or prints an error and returns -1
+static inline int traceOpen(TraceReader *reader, const char *path) {
+    reader->path = path;
+    reader->pos = 0;
+    reader->len = 0;
+    reader->line = 0;
+    reader->started = 0;
+    reader->file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (reader->file == NULL) {
+        fprintf(stderr, "Error opening trace file %s\n", path);
+        return -1;
+    }
+
+    reader->buffer = malloc(TRACE_BUFFER_SIZE);
+    reader->seenPids = calloc(TRACE_PID_PAGES, sizeof(uint64_t *));
+    if (reader->buffer == NULL || reader->seenPids == NULL) {
+        fprintf(stderr, "Error allocating trace buffer\n");
+        free(reader->buffer);
+        free(reader->seenPids);
+        if (reader->file != stdin) fclose(reader->file);
+        return -1;
+    }
+    return 0;
+}
+
+// Close a trace file opened with traceOpen
+static inline void traceClose(TraceReader *reader) {
+    if (reader->file != NULL && reader->file != stdin) fclose(reader->file);
+    free(reader->buffer);
+    if (reader->seenPids != NULL) {
+        for (int page = 0; page < TRACE_PID_PAGES; page++) free(reader->seenPids[page]);
+        free(reader->seenPids);
+    }
+    reader->file = NULL;
+    reader->buffer = NULL;
+    reader->seenPids = NULL;
+}
+
+// Next byte of the trace, refilling the buffer when it runs dry
+// read() returns whatever a pipe holds instead of waiting for a full buffer,
+// so a trace that is still being written can be consumed line by line
+static inline int traceGetc(TraceReader *reader) {
+    if (reader->pos == reader->len) {
+        ssize_t got;
+        do {
+            got = read(fileno(reader->file), reader->buffer, TRACE_BUFFER_SIZE);
+        } while (got < 0 && errno == EINTR);
+        reader->len = got > 0 ? (size_t)got : 0;
+        reader->pos = 0;
+        if (reader->len == 0) return EOF;
+    }
+    return (unsigned char)reader->buffer[reader->pos++];
+}
+
+// Print a parse error with its location
+static inline void traceError(TraceReader *reader, const char *message) {
+    fprintf(stderr, "%s:%ld: %s\n", reader->path, reader->line, message);
+}
+
+// Record that pid has been read
+// Returns 1 if an earlier line already had it, 0 if not, or -1 if memory ran out
+// Dense pids (1..n, as most traces have) touch one 64 KB page per 2^19 pids
+static inline int traceSeenPid(TraceReader *reader, int pid) {
+    uint64_t **page = &reader->seenPids[pid >> TRACE_PID_PAGE_BITS];
+    if (*page == NULL) {
+        *page = calloc(((size_t)1 << TRACE_PID_PAGE_BITS) / 64, sizeof(uint64_t));
+        if (*page == NULL) return -1;
+    }
+    unsigned bit = (unsigned)pid & ((1u << TRACE_PID_PAGE_BITS) - 1);
+    uint64_t mask = 1ULL << (bit & 63);
+    if ((*page)[bit >> 6] & mask) return 1;
+    (*page)[bit >> 6] |= mask;
+    return 0;
+}
+
+// Read the next record into *record
+// Returns 1 when a record was read, 0 at end of file, or -1 on a malformed line
+static inline int traceNext(TraceReader *reader, TraceRecord *record) {
+    int c = traceGetc(reader);
+
+    while (c != EOF) {
+        long long fields[TRACE_MAX_FIELDS];
+        int count = 0;
+        int isHeader = 0;
+        reader->line++;
+
+        // Parse the fields of one line
+        while (c != EOF && c != '\n') {
+            if (c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r') {
+                c = traceGetc(reader);
+                continue;
+            }
+            if (c == '#') {
+                while (c != EOF && c != '\n') c = traceGetc(reader);
+                break;
+            }
+
+            int negative = 0;
+            if (c == '-' || c == '+') {
+                negative = (c == '-');
+                c = traceGetc(reader);
+            }
+
+            if (c < '0' || c > '9') {
+                // A line of column names is allowed before the first record
+                // (after any blank or comment lines)
+                if (!reader->started && count == 0) {
+                    isHeader = 1;
+                    while (c != EOF && c != '\n') c = traceGetc(reader);
+                    break;
+                }
+                traceError(reader, "expected an integer");
+                return -1;
+            }
+
+            long long value = 0;
+            while (c >= '0' && c <= '9') {
+                value = value * 10 + (c - '0');
+                if (value > INT_MAX) {
+                    traceError(reader, "value out of range");
+                    return -1;
+                }
+                c = traceGetc(reader);
+            }
+
+            if (count == TRACE_MAX_FIELDS) {
+                traceError(reader, "too many fields (expected pid, arrival, burst[, priority])");
+                return -1;
+            }
+            fields[count++] = negative ? -value : value;
+        }
+
+        // Move past the newline that ended this line
+        if (c == '\n') c = traceGetc(reader);
+
+        // Blank, comment-only and header lines carry no record
+        if (isHeader) reader->started = 1;
+        if (count == 0 || isHeader) continue;
+        reader->started = 1;
+
+        if (count < 3) {
+            traceError(reader, "expected pid, arrival, burst[, priority]");
+            return -1;
+        }
+        if (fields[0] < 1) {
+            traceError(reader, "process ID must be at least 1");
+            return -1;
+        }
+        if (fields[1] < 0) {
+            traceError(reader, "arrival time cannot be negative");
+            return -1;
+        }
+        if (fields[2] < 1) {
+            traceError(reader, "burst time must be at least 1");
+            return -1;
+        }
+        int seen = traceSeenPid(reader, (int)fields[0]);
+        if (seen != 0) {
+            traceError(reader, seen > 0 ? "duplicate process ID" : "out of memory tracking process IDs");
+            return -1;
+        }
+
+        record->pid = (int)fields[0];
+        record->arrivalTime = (int)fields[1];
+        record->burstTime = (int)fields[2];
+        record->priority = count > 3 ? (int)fields[3] : 0;
+
+        // Leave the first byte of the next line for the following call
+        if (c != EOF) reader->pos--;
+        return 1;
+    }
+    return 0;
+}
+
+// Returns 1 if path is a binary trace (starts with TRACE_BINARY_MAGIC), else 0
+static inline int traceIsBinary(const char *path) {
+    char magic[8];
+    if (strcmp(path, "-") == 0) return 0;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    size_t got = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return got == sizeof(magic) && memcmp(magic, TRACE_BINARY_MAGIC, sizeof(magic)) == 0;
+}
+
+// Map a binary trace read-only and check its header and size
+// Only O(1) checks happen here: each record is validated when
+// traceMappedRecord() first reads it, so mapping a huge trace costs nothing
+// up front and the columns are never copied
+// Returns 0 on success, or prints an error and returns -1
+static inline int traceMap(const char *path, TraceMapping *mapping) {
+    struct stat info;
+    TraceBinaryHeader header;
+
+    memset(mapping, 0, sizeof(*mapping));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening trace file %s\n", path);
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(header)) {
+        fprintf(stderr, "%s: not a binary trace\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error mapping trace file %s\n", path);
+        return -1;
+    }
+    mapping->map = map;
+    mapping->mapSize = (size_t)info.st_size;
+
+    memcpy(&header, map, sizeof(header));
+    if (memcmp(header.magic, TRACE_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_BINARY_VERSION) {
+        fprintf(stderr, "%s: not a version %d binary trace\n", path, TRACE_BINARY_VERSION);
+        munmap(map, mapping->mapSize);
+        return -1;
+    }
+    if (header.count == 0 || header.count > INT_MAX ||
+        mapping->mapSize != sizeof(header) + 4 * header.count * sizeof(int32_t)) {
+        fprintf(stderr, "%s: record count does not match file size\n", path);
+        munmap(map, mapping->mapSize);
+        return -1;
+    }
+
+    const int32_t *columns = (const int32_t *)((const char *)map + sizeof(header));
+    mapping->count = (int)header.count;
+    mapping->flags = header.flags;
+    mapping->path = path;
+    mapping->arrival = columns;
+    mapping->burst = columns + header.count;
+    mapping->pid = columns + 2 * header.count;
+    mapping->priority = columns + 3 * header.count;
+
+    // Tell the kernel the columns will be read front to back
+    madvise(map, mapping->mapSize, MADV_SEQUENTIAL);
+    return 0;
+}
+
+// Release a mapping created by traceMap
+static inline void traceUnmap(TraceMapping *mapping) {
+    if (mapping->map != NULL) munmap(mapping->map, mapping->mapSize);
+    memset(mapping, 0, sizeof(*mapping));
+}
+
+// Copy record i of a mapped binary trace into *record and validate it with
+// the usual rules (and its order, if the trace claims to be sorted)
+// Returns 0 on success, or prints an error and returns -1
+static inline int traceMappedRecord(const TraceMapping *mapping, int i, TraceRecord *record) {
+    const char *problem = NULL;
+    if (mapping->pid[i] < 1) problem = "process ID must be at least 1";
+    else if (mapping->arrival[i] < 0) problem = "arrival time cannot be negative";
+    else if (mapping->burst[i] < 1) problem = "burst time must be at least 1";
+    else if ((mapping->flags & TRACE_BINARY_SORTED) && i > 0 &&
+             mapping->arrival[i] < mapping->arrival[i - 1]) problem = "records are not sorted by arrival";
+    if (problem != NULL) {
+        fprintf(stderr, "%s: record %d: %s\n", mapping->path, i + 1, problem);
+        return -1;
+    }
+
+    record->pid = mapping->pid[i];
+    record->arrivalTime = mapping->arrival[i];
+    record->burstTime = mapping->burst[i];
+    record->priority = mapping->priority[i];
+    return 0;
+}
+
+// Write records as a binary trace, with the given TRACE_BINARY_* flags
+// Returns 0 on success, or prints an error and returns -1
+static inline int traceWriteBinary(const char *path, const TraceRecord *records, int count, uint32_t flags) {
+    TraceBinaryHeader header;
+    int32_t *column = malloc((size_t)count * sizeof(int32_t));
+    FILE *file = fopen(path, "wb");
+
+    if (column == NULL || file == NULL) {
+        fprintf(stderr, "Error opening %s for writing\n", path);
+        free(column);
+        if (file != NULL) fclose(file);
+        return -1;
+    }
+
+    memcpy(header.magic, TRACE_BINARY_MAGIC, sizeof(header.magic));
+    header.version = TRACE_BINARY_VERSION;
+    header.flags = flags;
+    header.count = (uint64_t)count;
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // Columns are written one after another: arrival, burst, pid, priority
+    for (int field = 0; field < 4 && ok; field++) {
+        for (int i = 0; i < count; i++) {
+            const TraceRecord *r = &records[i];
+            column[i] = field == 0 ? r->arrivalTime : field == 1 ? r->burstTime :
+                        field == 2 ? r->pid : r->priority;
+        }
+        ok = fwrite(column, sizeof(int32_t), (size_t)count, file) == (size_t)count;
+    }
+
+    free(column);
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Error writing %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Copy every record of a binary trace into trace->records
+static inline int traceLoadBinary(const char *path, Trace *trace) {
+    TraceMapping mapping;
+    if (traceMap(path, &mapping) != 0) return -1;
+
+    trace->records = malloc((size_t)mapping.count * sizeof(TraceRecord));
+    if (trace->records == NULL) {
+        fprintf(stderr, "Error allocating memory for trace records\n");
+        traceUnmap(&mapping);
+        return -1;
+    }
+    for (int i = 0; i < mapping.count; i++) {
+        if (traceMappedRecord(&mapping, i, &trace->records[i]) != 0) {
+            free(trace->records);
+            trace->records = NULL;
+            traceUnmap(&mapping);
+            return -1;
+        }
+    }
+    trace->count = mapping.count;
+    trace->capacity = mapping.count;
+    traceUnmap(&mapping);
+    return trace->count;
+}
+
+// Load every record of a trace file (text or binary) into memory
+// Returns the number of records, or prints an error and returns -1
+static inline int traceLoad(const char *path, Trace *trace) {
+    TraceReader reader;
+    TraceRecord record;
+    int status;
+
+    trace->records = NULL;
+    trace->count = 0;
+    trace->capacity = 0;
+
+    if (traceIsBinary(path)) return traceLoadBinary(path, trace);
+    if (traceOpen(&reader, path) != 0) return -1;
+
+    while ((status = traceNext(&reader, &record)) == 1) {
+        // Grow the record array geometrically
+        if (trace->count == trace->capacity) {
+            int capacity = trace->capacity > 0 ? trace->capacity * 2 : 1024;
+            TraceRecord *records = realloc(trace->records, (size_t)capacity * sizeof(TraceRecord));
+            if (records == NULL) {
+                fprintf(stderr, "Error allocating memory for trace records\n");
+                status = -1;
+                break;
+            }
+            trace->records = records;
+            trace->capacity = capacity;
+        }
+        trace->records[trace->count++] = record;
+    }
+    traceClose(&reader);
+
+    if (status == 0 && trace->count == 0) {
+        fprintf(stderr, "%s: trace contains no processes\n", path);
+        status = -1;
+    }
+    if (status != 0) {
+        free(trace->records);
+        trace->records = NULL;
+        trace->count = 0;
+        return -1;
+    }
+    return trace->count;
+}
+
+// Free the records of a loaded trace
+static inline void traceFree(Trace *trace) {
+    free(trace->records);
+    trace->records = NULL;
+    trace->count = 0;
+    trace->capacity = 0;
+}
+
+#endif